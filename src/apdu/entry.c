@@ -58,7 +58,17 @@ void handle_apdu(volatile unsigned int *flags, volatile unsigned int *tx) {
                                 G_io_apdu_buffer[OFFSET_P2],
                                 G_io_apdu_buffer + OFFSET_CDATA,
                                 G_io_apdu_buffer[OFFSET_LC],
-                                flags);
+                                flags,
+                                tx);
+                    break;
+
+                case INS_PARSE:
+                    handle_parse(G_io_apdu_buffer[OFFSET_P1],
+                                 G_io_apdu_buffer[OFFSET_P2],
+                                 G_io_apdu_buffer + OFFSET_CDATA,
+                                 G_io_apdu_buffer[OFFSET_LC],
+                                 flags,
+                                 tx);
                     break;
 
                 case INS_GET_APP_CONFIGURATION:
@@ -23,6 +23,7 @@
 #include "constants.h"
 #include "xrp_parse.h"
 #include "xrp_helpers.h"
+#include "format_cache.h"
 
 typedef enum {
     IDLE,
@@ -42,8 +43,7 @@ typedef struct swapStrings_t {
 } swapStrings_t;
 
 typedef struct reviewStrings_t {
-    field_name_t field_name;
-    field_value_t field_value;
+    formatCache_t cache;  // The review steps display the entries in place
 } reviewStrings_t;
 
 typedef union {
@@ -64,6 +64,12 @@ typedef struct transactionContext_t {
     uint32_t bip32_path[MAX_BIP32_PATH];
     uint8_t raw_tx[MAX_RAW_TX];
     uint32_t raw_tx_length;
+#ifndef TARGET_NANOS
+    // secp256k1 signing hash, updated while the transaction is received
+    cx_sha512_t hash;
+    uint32_t hashed_length;
+#endif
+    bool dry_run;  // Reply with a summary instead of reviewing the transaction
 } transactionContext_t;
 
 typedef union {
@@ -24,12 +24,16 @@
 #include "global.h"
 #include "transaction.h"
 #include "idle_menu.h"
+#include "review_menu.h"
 #include "xrp_helpers.h"
 #include "crypto_helpers.h"
 
 static const uint8_t prefix_length = 4;
 static const uint8_t suffix_length = 20;
 
+// Response data of a dry run, which must fit a short APDU along with the status word
+#define MAX_SUMMARY_LENGTH 253
+
 static const uint8_t sign_prefix[] = {0x53, 0x54, 0x58, 0x00};
 static const uint8_t sign_prefix_multi[] = {0x53, 0x4D, 0x54, 0x00};
 
@@ -39,7 +43,8 @@ void handle_packet_content(uint8_t p1,
                            uint8_t p2,
                            uint8_t *work_buffer,
                            uint8_t data_length,
-                           volatile unsigned int *flags);
+                           volatile unsigned int *flags,
+                           volatile unsigned int *tx);
 
 void sign_transaction() {
     uint8_t key_buffer[64];
@@ -92,10 +97,22 @@ void sign_transaction() {
     }
 
     if (tmp_ctx.transaction_context.curve == CX_CURVE_256K1) {
+#ifdef TARGET_NANOS
         cx_hash_sha512(tmp_ctx.transaction_context.raw_tx,
                        tmp_ctx.transaction_context.raw_tx_length,
                        key_buffer,
                        64);
+#else
+        // Most of the transaction has already been hashed while it was received,
+        // only the remaining data (such as the multi-sign suffix) is hashed here
+        CX_CHECK(cx_hash_no_throw(
+            &tmp_ctx.transaction_context.hash.header,
+            CX_LAST,
+            tmp_ctx.transaction_context.raw_tx + tmp_ctx.transaction_context.hashed_length,
+            tmp_ctx.transaction_context.raw_tx_length - tmp_ctx.transaction_context.hashed_length,
+            key_buffer,
+            64));
+#endif
         PRINTF("Hash to sign:\n%.*H\n", 32, key_buffer);
         io_seproxyhal_io_heartbeat();
 
@@ -171,6 +188,62 @@ void reject_transaction() {
 #endif
 }
 
+static const uint8_t *get_prefix() {
+    return parse_context.has_empty_pub_key ? sign_prefix_multi : sign_prefix;
+}
+
+#ifdef TARGET_NANOS
+// The SHA-512 context (about 200 bytes) doesn't fit in the RAM of Nano S, so there the
+// transaction is hashed at once when it is signed
+static void update_transaction_hash(bool is_complete) {
+    UNUSED(is_complete);
+}
+#else
+// For secp256k1 the SHA-512 hash of the transaction is computed while it is received, so that
+// only the multi-sign suffix and the final block are left to hash once the user has approved it.
+// The prefix depends on whether SigningPubKey is empty, so hashing is deferred until that field
+// has been parsed, or until the whole transaction has been received if it has no such field.
+static void update_transaction_hash(bool is_complete) {
+    transactionContext_t *context = &tmp_ctx.transaction_context;
+    cx_err_t error;
+
+    if (context->curve != CX_CURVE_256K1 || context->dry_run) {
+        return;
+    }
+
+    if (context->hashed_length != 0 &&
+        memcmp(context->raw_tx, get_prefix(), prefix_length) != 0) {
+        // A later SigningPubKey field has changed the prefix, start over
+        context->hashed_length = 0;
+    }
+
+    if (context->hashed_length == 0) {
+        if (!has_field(&parse_context, STI_VL, XRP_VL_SIGNING_PUB_KEY) && !is_complete) {
+            return;
+        }
+
+        memmove(context->raw_tx, get_prefix(), prefix_length);
+        error = cx_sha512_init_no_throw(&context->hash);
+        if (error != CX_OK) {
+            THROW(error);
+        }
+    }
+
+    uint32_t length = prefix_length + parse_context.length;
+    error = cx_hash_no_throw(&context->hash.header,
+                             0,
+                             context->raw_tx + context->hashed_length,
+                             length - context->hashed_length,
+                             NULL,
+                             0);
+    if (error != CX_OK) {
+        THROW(error);
+    }
+
+    context->hashed_length = length;
+}
+#endif
+
 bool is_first(uint8_t p1) {
     return (p1 & P1_MASK_ORDER) == 0;
 }
@@ -179,18 +252,63 @@ bool has_more(uint8_t p1) {
     return (p1 & P1_MASK_MORE) != 0;
 }
 
+// Reply with where and why the transaction was rejected, before the status word:
+// offset (2 bytes, big endian), data type, field code and parseReason_t
+static void throw_parse_error(int exception, volatile unsigned int *tx) {
+    const parseError_t *error = &parse_context.error;
+
+    G_io_apdu_buffer[0] = error->offset >> 8u;
+    G_io_apdu_buffer[1] = error->offset;
+    G_io_apdu_buffer[2] = error->data_type;
+    G_io_apdu_buffer[3] = error->id;
+    G_io_apdu_buffer[4] = error->reason;
+    *tx = 5;
+
+    THROW(exception);
+}
+
+// Reply with a summary of the transaction instead of reviewing it: transaction type
+// (2 bytes, big endian), field count and screen count, followed by the data type,
+// field code, offset (2 bytes) and length (2 bytes) of the fields in display order,
+// for as many fields as fit in the response
+static void reply_summary(volatile unsigned int *tx) {
+    uint8_t count = get_field_count(&parse_context);
+
+    G_io_apdu_buffer[0] = parse_context.transaction_type >> 8u;
+    G_io_apdu_buffer[1] = parse_context.transaction_type;
+    G_io_apdu_buffer[2] = count;
+    G_io_apdu_buffer[3] = get_review_screen_count(&parse_context);
+    *tx = 4;
+
+    for (uint8_t i = 0; i < count && *tx + 6 <= MAX_SUMMARY_LENGTH; ++i) {
+        const field_t *field = get_field(&parse_context, i);
+
+        G_io_apdu_buffer[*tx] = field->data_type;
+        G_io_apdu_buffer[*tx + 1] = field->id;
+        G_io_apdu_buffer[*tx + 2] = field->offset >> 8u;
+        G_io_apdu_buffer[*tx + 3] = field->offset;
+        G_io_apdu_buffer[*tx + 4] = field->length >> 8u;
+        G_io_apdu_buffer[*tx + 5] = field->length;
+        *tx += 6;
+    }
+}
+
 void handle_first_packet(uint8_t p1,
                          uint8_t p2,
                          uint8_t *work_buffer,
                          uint8_t data_length,
-                         volatile unsigned int *flags) {
+                         volatile unsigned int *flags,
+                         volatile unsigned int *tx,
+                         bool dry_run) {
     if (!is_first(p1)) {
         THROW(0x6A80);
     }
 
     // Reset old transaction data that might still remain
     reset_transaction_context();
+    tmp_ctx.transaction_context.dry_run = dry_run;
     parse_context.data = tmp_ctx.transaction_context.raw_tx + prefix_length;
+    parse_tx_init(&parse_context);
 
     size_t path_length = work_buffer[0];
     uint32_t *path_parsed = tmp_ctx.transaction_context.bip32_path;
@@ -215,26 +333,28 @@ void handle_first_packet(uint8_t p1,
     tmp_ctx.transaction_context.curve =
         (((p2 & P2_ED25519) != 0) ? CX_CURVE_Ed25519 : CX_CURVE_256K1);
 
-    handle_packet_content(p1, p2, work_buffer, data_length, flags);
+    handle_packet_content(p1, p2, work_buffer, data_length, flags, tx);
 }
 
 void handle_subsequent_packet(uint8_t p1,
                               uint8_t p2,
                               uint8_t *work_buffer,
                               uint8_t data_length,
-                              volatile unsigned int *flags) {
+                              volatile unsigned int *flags,
+                              volatile unsigned int *tx) {
     if (is_first(p1)) {
         THROW(0x6A80);
     }
 
-    handle_packet_content(p1, p2, work_buffer, data_length, flags);
+    handle_packet_content(p1, p2, work_buffer, data_length, flags, tx);
 }
 
 void handle_packet_content(uint8_t p1,
                            uint8_t p2,
                            uint8_t *work_buffer,
                            uint8_t data_length,
-                           volatile unsigned int *flags) {
+                           volatile unsigned int *flags,
+                           volatile unsigned int *tx) {
     UNUSED(p2);
 
     uint16_t total_length = prefix_length + parse_context.length + data_length;
@@ -247,6 +367,16 @@ void handle_packet_content(uint8_t p1,
     memmove(parse_context.data + parse_context.length, work_buffer, data_length);
     parse_context.length += data_length;
 
+    // Parse all fields that are complete so far. If the parsing fails an exception is thrown,
+    // causing the processing to abort at the first bad chunk and the transaction context to
+    // be reset.
+    int exception = parse_tx_update(&parse_context);
+    if (exception) {
+        throw_parse_error(exception, tx);
+    }
+
+    update_transaction_hash(false);
+
     if (has_more(p1)) {
         // Reply to sender with status OK
         sign_state = WAITING_FOR_MORE;
@@ -257,44 +387,73 @@ void handle_packet_content(uint8_t p1,
 
         tmp_ctx.transaction_context.raw_tx_length = prefix_length + parse_context.length;
 
-        // Try to parse the transaction. If the parsing fails an exception is thrown,
-        // causing the processing to abort and the transaction context to be reset.
-        int exception = parse_tx(&parse_context);
+        // Finish parsing the transaction, which fails if the last field is truncated
+        exception = parse_tx_finish(&parse_context);
         if (exception) {
-            THROW(exception);
+            throw_parse_error(exception, tx);
         }
 
-        // Set transaction prefix (space has been reserved earlier)
-        if (parse_context.has_empty_pub_key) {
-            if (tmp_ctx.transaction_context.raw_tx_length + suffix_length > MAX_RAW_TX) {
-                // Abort if the added account ID suffix causes the transaction to be too large
-                THROW(0x6700);
-            }
+        if (parse_context.has_empty_pub_key &&
+            tmp_ctx.transaction_context.raw_tx_length + suffix_length > MAX_RAW_TX) {
+            // Abort if the added account ID suffix causes the transaction to be too large
+            THROW(0x6700);
+        }
 
-            memmove(tmp_ctx.transaction_context.raw_tx, sign_prefix_multi, prefix_length);
-        } else {
-            memmove(tmp_ctx.transaction_context.raw_tx, sign_prefix, prefix_length);
+        if (tmp_ctx.transaction_context.dry_run) {
+            reply_summary(tx);
+            reset_transaction_context();
+            THROW(0x9000);
         }
 
-        review_transaction(&parse_context.result, sign_transaction, reject_transaction);
+        // Hash the data whose prefix wasn't known yet, then set the transaction prefix
+        // (space has been reserved earlier)
+        update_transaction_hash(true);
+        memmove(tmp_ctx.transaction_context.raw_tx, get_prefix(), prefix_length);
+
+        review_transaction(&parse_context, sign_transaction, reject_transaction);
 
         *flags |= IO_ASYNCH_REPLY;
     }
 }
 
-void handle_sign(uint8_t p1,
-                 uint8_t p2,
-                 uint8_t *work_buffer,
-                 uint8_t data_length,
-                 volatile unsigned int *flags) {
+static void handle_upload(uint8_t p1,
+                          uint8_t p2,
+                          uint8_t *work_buffer,
+                          uint8_t data_length,
+                          volatile unsigned int *flags,
+                          volatile unsigned int *tx,
+                          bool dry_run) {
     switch (sign_state) {
         case IDLE:
-            handle_first_packet(p1, p2, work_buffer, data_length, flags);
+            handle_first_packet(p1, p2, work_buffer, data_length, flags, tx, dry_run);
             break;
         case WAITING_FOR_MORE:
-            handle_subsequent_packet(p1, p2, work_buffer, data_length, flags);
+            // All chunks must be sent with the instruction of the first one, so that a
+            // transaction uploaded for PARSE can't be signed and the other way round
+            if (dry_run != tmp_ctx.transaction_context.dry_run) {
+                THROW(0x6A80);
+            }
+            handle_subsequent_packet(p1, p2, work_buffer, data_length, flags, tx);
             break;
         default:
             THROW(0x6A80);
     }
 }
+
+void handle_sign(uint8_t p1,
+                 uint8_t p2,
+                 uint8_t *work_buffer,
+                 uint8_t data_length,
+                 volatile unsigned int *flags,
+                 volatile unsigned int *tx) {
+    handle_upload(p1, p2, work_buffer, data_length, flags, tx, false);
+}
+
+void handle_parse(uint8_t p1,
+                  uint8_t p2,
+                  uint8_t *work_buffer,
+                  uint8_t data_length,
+                  volatile unsigned int *flags,
+                  volatile unsigned int *tx) {
+    handle_upload(p1, p2, work_buffer, data_length, flags, tx, true);
+}
@@ -28,6 +28,15 @@ void handle_sign(uint8_t p1,
                  uint8_t p2,
                  uint8_t *work_buffer,
                  uint8_t data_length,
-                 volatile unsigned int *flags);
+                 volatile unsigned int *flags,
+                 volatile unsigned int *tx);
+
+// Same as handle_sign, but the transaction is only parsed and summarised
+void handle_parse(uint8_t p1,
+                  uint8_t p2,
+                  uint8_t *work_buffer,
+                  uint8_t data_length,
+                  volatile unsigned int *flags,
+                  volatile unsigned int *tx);
 
 #endif  // LEDGER_APP_XRP_SIGNTRANSACTION_H
@@ -32,20 +32,70 @@
 // Hardware dependent limits
 //   Ledger Nano X has 30K RAM
 //   Ledger Nano S has 4K RAM
+//
+// The field counts were doubled when field_t was made compact (an offset instead of a
+// pointer per field, 12 bytes on ARM with short enums, now 10 bytes):
+//   Nano S:        24 x 12 = 288 bytes ->  48 x 10 = 480 bytes
+//   Other targets: 60 x 12 = 720 bytes -> 120 x 10 = 1200 bytes
+//
+// FORMAT_CACHE_SIZE is the number of formatted fields that are kept during the review
+// (see format_cache.h), enough to go back and forth between two steps on Nano S and
+// for a whole NBGL page elsewhere.
+//
+// ADDRESS_CACHE_SIZE is the number of accounts whose classic address is kept during
+// the transaction (see address_cache.h), 56 bytes each. Three cover the Account, the
+// Destination and an issuer on Nano S.
+//
+// MAX_NESTING_DEPTH is the number of arrays and objects that can be nested, each of
+// them using a 6 bytes parseFrame_t. An array item and the array itself both count,
+// so a depth of 4 allows for instance the objects of an array in an array item.
+//
+// The parse context (parseContext_t, without lazy parsing) takes 760 bytes on Nano S
+// and 1784 bytes on the other targets, against 312 and 744 bytes before the changes
+// above:
+//                                Nano S   Others
+//   Field records                   482     1202
+//   Nesting frames                   34       58
+//   Seen fields and schema mask      40       40
+//   Error diagnostics                 6        6
+//   Address cache                   170      450
+//   Other members and padding        28       28
 #if defined(TARGET_NANOS)
 
-#define MAX_FIELD_COUNT        24
+#define MAX_FIELD_COUNT        48
+#define MAX_NESTING_DEPTH      4
 #define MAX_FIELD_LEN          128
 #define MAX_RAW_TX             800
+#define FORMAT_CACHE_SIZE      2
+#define ADDRESS_CACHE_SIZE     3
 #define DISPLAY_SEGMENTED_ADDR true
 
 #else
 
-#define MAX_FIELD_COUNT        60
+#define MAX_FIELD_COUNT        120
+#define MAX_NESTING_DEPTH      8
 #define MAX_FIELD_LEN          1024
 #define MAX_RAW_TX             10000
+#define FORMAT_CACHE_SIZE      5
+#define ADDRESS_CACHE_SIZE     8
 #define DISPLAY_SEGMENTED_ADDR false
 
 #endif
 
+// Lazy parsing, enabled by defining PARSE_CHECKPOINT_INTERVAL (for instance with
+// DEFINES += PARSE_CHECKPOINT_INTERVAL=8). Instead of storing every field, the parser
+// only stores its state (8 bytes) every PARSE_CHECKPOINT_INTERVAL fields and fields are
+// decoded again from the nearest checkpoint when they are displayed. The number of
+// fields is then only limited by the 8-bit field index, and an interval of 8 uses
+// 32 x 8 = 256 bytes instead of the 480 bytes of the parsed fields on Nano S.
+// Checkpoints are only stored while at most one array is open, such as inside memos,
+// so that they don't need to hold the whole parseFrame_t stack.
+#ifdef PARSE_CHECKPOINT_INTERVAL
+
+#undef MAX_FIELD_COUNT
+#define MAX_FIELD_COUNT      255
+#define MAX_CHECKPOINT_COUNT (MAX_FIELD_COUNT / PARSE_CHECKPOINT_INTERVAL + 1)
+
+#endif
+
 #endif  // LEDGER_APP_XRP_LIMITATIONS_H
@@ -25,8 +25,9 @@
 #include "fields.h"
 #include "amount.h"
 #include "fmt.h"
+#include "text_writer.h"
 #include "readers.h"
-#include "xrp_helpers.h"
+#include "address_cache.h"
 #include "handle_swap_sign_transaction.h"
 #include <string.h>
 
@@ -34,6 +35,10 @@ static action_t approval_action;
 static action_t rejection_action;
 
 void on_approval_menu_result(unsigned int result) {
+    PRINTF("Format cache: %d hits, %d misses\n",
+           approval_strings.review.cache.hits,
+           approval_strings.review.cache.misses);
+
     switch (result) {
         case OPTION_SIGN:
 #ifdef HAVE_BAGL
@@ -52,7 +57,8 @@ void on_approval_menu_result(unsigned int result) {
     }
 }
 
-static bool check_field(const field_t *field,
+static bool check_field(parseContext_t *transaction,
+                        const field_t *field,
                         field_type_t data_type,
                         uint8_t id,
                         bool compare_value,
@@ -68,13 +74,14 @@ static bool check_field(const field_t *field,
     bool ret;
     switch (data_type) {
         case STI_UINT16:
-            ret = (field->data.u16 == (uint16_t) value);
+            ret = (field_u16(transaction, field) == (uint16_t) value);
             break;
         case STI_UINT32:
-            ret = (field->data.u32 == (uint32_t) value);
+            ret = (field_u32(transaction, field) == (uint32_t) value);
             break;
         case STI_AMOUNT:
-            ret = (field->length == XRP_AMOUNT_LEN && read_unsigned64(field->data.ptr) == value);
+            ret = (field->length == XRP_AMOUNT_LEN &&
+                   read_unsigned64(field_data(transaction, field)) == value);
             break;
         default:
             ret = false;
@@ -97,37 +104,44 @@ Example of such a swappable TX (as it would be displayed with the approval flow)
     "Destination" : "rhBuYom8agWA4s7DFoM7AvsDA9XGkVCJz4"
 }
  */
-bool check_swap_conditions_and_sign(parseResult_t *transaction) {
+bool check_swap_conditions_and_sign(parseContext_t *transaction) {
     if (!called_from_swap) {
         PRINTF("Not called from swap!\n");
         return false;
     }
 
-    if (transaction->num_fields != 6) {
-        PRINTF("Wrong num fields for swap: %d\n", transaction->num_fields);
+    if (get_field_count(transaction) != 6) {
+        PRINTF("Wrong num fields for swap: %d\n", get_field_count(transaction));
         return false;
     }
 
     size_t step_index = 0;
-    field_t *field = &transaction->fields[step_index++];
+    field_t *field = get_field(transaction, step_index++);
     // "Transaction Type" field
-    if (!check_field(field, STI_UINT16, XRP_UINT16_TRANSACTION_TYPE, true, TRANSACTION_PAYMENT)) {
+    if (!check_field(transaction,
+                     field,
+                     STI_UINT16,
+                     XRP_UINT16_TRANSACTION_TYPE,
+                     true,
+                     TRANSACTION_PAYMENT)) {
         return false;
     }
 
     // "Account" field
-    field = &transaction->fields[step_index++];
-    if (!check_field(field, STI_ACCOUNT, XRP_ACCOUNT_ACCOUNT, false, 0)) {
+    field = get_field(transaction, step_index++);
+    if (!check_field(transaction, field, STI_ACCOUNT, XRP_ACCOUNT_ACCOUNT, false, 0)) {
         return false;
     }
 
     // "Destination Tag" field
-    field = &transaction->fields[step_index++];
-    if (!check_field(field, STI_UINT32, XRP_VL_MEMO_FORMAT, false, 0)) {
+    field = get_field(transaction, step_index++);
+    if (!check_field(transaction, field, STI_UINT32, XRP_VL_MEMO_FORMAT, false, 0)) {
         return false;
     }
 
-    snprintf(approval_strings.swap.tmp, sizeof(approval_strings.swap.tmp), "%u", field->data.u32);
+    textWriter_t out;
+    writer_init(&out, approval_strings.swap.tmp, sizeof(approval_strings.swap.tmp));
+    write_uint(&out, field_u32(transaction, field));
     if (strncmp(approval_strings.swap.tmp,
                 approval_strings.swap.destination_tag,
                 sizeof(approval_strings.swap.destination_tag)) != 0) {
@@ -135,37 +149,39 @@ bool check_swap_conditions_and_sign(parseResult_t *transaction) {
     }
 
     // "Amount" field
-    field = &transaction->fields[step_index++];
+    field = get_field(transaction, step_index++);
     uint64_t amount = approval_strings.swap.amount;
     if (amount & 0x4000000000000000) {
         return false;
     }
     amount |= 0x4000000000000000;
-    if (!check_field(field, STI_AMOUNT, XRP_UINT64_AMOUNT, true, amount)) {
+    if (!check_field(transaction, field, STI_AMOUNT, XRP_UINT64_AMOUNT, true, amount)) {
         return false;
     }
 
-    field = &transaction->fields[step_index++];
+    field = get_field(transaction, step_index++);
     // "Fee" field
     uint64_t fee = approval_strings.swap.fee;
     if (fee & 0x4000000000000000) {
         return false;
     }
     fee |= 0x4000000000000000;
-    if (!check_field(field, STI_AMOUNT, XRP_UINT64_FEE, true, fee)) {
+    if (!check_field(transaction, field, STI_AMOUNT, XRP_UINT64_FEE, true, fee)) {
         return false;
     }
 
-    field = &transaction->fields[step_index++];
-    if (!check_field(field, STI_ACCOUNT, XRP_ACCOUNT_DESTINATION, false, 0)) {
+    field = get_field(transaction, step_index++);
+    if (!check_field(transaction, field, STI_ACCOUNT, XRP_ACCOUNT_DESTINATION, false, 0)) {
         return false;
     }
 
     // "Destination" field
-    xrp_address_t destination;
-    xrp_account_t *account = (xrp_account_t *) field->data.account;
-    size_t addr_length = xrp_public_key_to_encoded_base58(NULL, account, &destination, 0);
-    if (strncmp(destination.buf, approval_strings.swap.address, addr_length) != 0) {
+    xrp_account_t *account = (xrp_account_t *) field_data(transaction, field);
+    const cachedAddress_t *destination = get_encoded_address(&transaction->addresses, account);
+    if (destination->length == 0 ||
+        strnlen(approval_strings.swap.address, sizeof(approval_strings.swap.address)) !=
+            destination->length ||
+        memcmp(destination->address, approval_strings.swap.address, destination->length) != 0) {
         return false;
     }
 
@@ -174,7 +190,7 @@ bool check_swap_conditions_and_sign(parseResult_t *transaction) {
     return true;
 }
 
-void review_transaction(parseResult_t *transaction, action_t on_approve, action_t on_reject) {
+void review_transaction(parseContext_t *transaction, action_t on_approve, action_t on_reject) {
     approval_action = on_approve;
     rejection_action = on_reject;
 
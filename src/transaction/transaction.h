@@ -23,6 +23,6 @@
 
 typedef void (*resultAction_t)(unsigned int result);
 
-void review_transaction(parseResult_t *transaction, action_t on_approve, action_t on_reject);
+void review_transaction(parseContext_t *transaction, action_t on_approve, action_t on_reject);
 
 #endif  // LEDGER_APP_XRP_TRANSACTION_H
@@ -23,4 +23,7 @@
 #define OPTION_SIGN   0
 #define OPTION_REJECT 1
 
-void display_review_menu(parseResult_t *transaction_param, resultAction_t callback);
+void display_review_menu(parseContext_t *transaction_param, resultAction_t callback);
+
+// Estimated number of review screens, see PARSE XRP TRANSACTION in doc/xrpapp.asc
+uint8_t get_review_screen_count(parseContext_t *transaction_param);
@@ -18,28 +18,37 @@
 #include "review_menu.h"
 #include <os.h>
 #include <os_io_seproxyhal.h>
-#include <string.h>
 #include <ux.h>
 #include "global.h"
 #include "transaction.h"
+#include "format_cache.h"
 #include "fmt.h"
 
-parseResult_t *transaction;
+parseContext_t *transaction;
 resultAction_t approval_menu_callback;
 
-const ux_flow_step_t *ux_review_flow[MAX_FIELD_COUNT + 3];
+// The fields are displayed by a single step between two delimiters that update
+// the current field index and page, so that the flow doesn't depend on the field count
+// nor on the length of the values
+static uint8_t current_index;
+static uint8_t current_page;
+static bool inside_fields;
 
-static void update_content(int stack_slot);
+static void review_start(void);
+static void review_end(void);
 
 // clang-format off
-UX_STEP_NOCB_INIT(
-        ux_review_flow_step,
-        bnnn_paging,
-        update_content(stack_slot),
-        {
-            approval_strings.review.field_name.buf,
-            approval_strings.review.field_value.buf
-        });
+UX_STEP_INIT(
+        ux_review_flow_start,
+        NULL,
+        NULL,
+        review_start());
+
+UX_STEP_INIT(
+        ux_review_flow_end,
+        NULL,
+        NULL,
+        review_end());
 
 UX_STEP_CB(
         ux_review_flow_sign,
@@ -58,49 +67,92 @@ UX_STEP_CB(
             &C_icon_crossmark,
             "Reject",
         });
+
 // clang-format on
 
-static void update_title(field_t *field, field_name_t *title) {
-    const char *name = resolve_field_name(field);
-    strncpy(title->buf, name, sizeof(title->buf));
-    title->buf[sizeof(title->buf) - 1] = '\x00';
-
-    size_t len = strlen(title->buf);
-    if (field->array_info.type == ARRAY_PATHSET) {
-        snprintf(title->buf + len,
-                 sizeof(title->buf) - len,
-                 " [P%d: S%d]",
-                 field->array_info.index1,
-                 field->array_info.index2);
-    } else if (field->array_info.type != ARRAY_NONE) {
-        snprintf(title->buf + len, sizeof(title->buf) - len, " [%d]", field->array_info.index1);
-    }
+// The field step is written out instead of using UX_STEP_NOCB_INIT, whose parameters are
+// constant: the title and text point at the cache entry of the current field page
+static ux_layout_bnnn_paging_params_t review_field_params;
+
+static void review_field_init(unsigned int stack_slot) {
+    const formattedField_t *entry = get_formatted_field(&approval_strings.review.cache,
+                                                        transaction,
+                                                        current_index,
+                                                        current_page);
+
+    review_field_params.title = entry->name.buf;
+    review_field_params.text = entry->value.buf;
+    ux_layout_bnnn_paging_init(stack_slot);
 }
 
-static void update_value(field_t *field, field_value_t *value) {
-    format_field(field, value);
+const ux_flow_step_t ux_review_flow_step = {review_field_init, &review_field_params, NULL, NULL};
+
+// clang-format off
+UX_FLOW(ux_review_flow,
+        &ux_review_flow_start,
+        &ux_review_flow_step,
+        &ux_review_flow_end,
+        &ux_review_flow_sign,
+        &ux_review_flow_reject);
+// clang-format on
+
+static uint8_t get_last_page(uint8_t index) {
+    return get_field_page_count(transaction, get_field(transaction, index)) - 1;
 }
 
-static void update_content(int stack_slot) {
-    int step_index = G_ux.flow_stack[stack_slot].index;
-    field_t *field = &transaction->fields[step_index];
+// Entered when going backwards from a field, or when the flow starts
+static void review_start(void) {
+    if (inside_fields && current_page > 0) {
+        current_page--;
+    } else if (inside_fields && current_index > 0) {
+        current_index--;
+        current_page = get_last_page(current_index);
+    } else {
+        // Nothing before the first field, display it again
+        current_index = 0;
+        current_page = 0;
+        inside_fields = true;
+    }
 
-    update_title(field, &approval_strings.review.field_name);
-    update_value(field, &approval_strings.review.field_value);
+    ux_flow_next();
+}
+
+// Entered when going forwards from a field, or backwards from the sign step
+static void review_end(void) {
+    if (!inside_fields) {
+        current_index = get_field_count(transaction) - 1;
+        current_page = get_last_page(current_index);
+        inside_fields = true;
+        ux_flow_prev();
+    } else if (current_page < get_last_page(current_index)) {
+        current_page++;
+        ux_flow_prev();
+    } else if (current_index + 1 < get_field_count(transaction)) {
+        current_index++;
+        current_page = 0;
+        ux_flow_prev();
+    } else {
+        inside_fields = false;
+        ux_flow_next();
+    }
 }
 
-void display_review_menu(parseResult_t *transaction_param, resultAction_t callback) {
+void display_review_menu(parseContext_t *transaction_param, resultAction_t callback) {
     transaction = transaction_param;
     approval_menu_callback = callback;
 
-    for (int i = 0; i < transaction->num_fields; ++i) {
-        ux_review_flow[i] = &ux_review_flow_step;
-    }
-
-    ux_review_flow[transaction->num_fields + 0] = &ux_review_flow_sign;
-    ux_review_flow[transaction->num_fields + 1] = &ux_review_flow_reject;
-    ux_review_flow[transaction->num_fields + 2] = FLOW_END_STEP;
+    current_index = 0;
+    current_page = 0;
+    inside_fields = false;
+    format_cache_reset(&approval_strings.review.cache);
 
     ux_flow_init(0, ux_review_flow, NULL);
 }
+
+uint8_t get_review_screen_count(parseContext_t *transaction_param) {
+    // One step per page of every field, then the sign and reject steps
+    uint16_t count = get_display_item_count(transaction_param) + 2;
+
+    return count > UINT8_MAX ? UINT8_MAX : count;
+}
 #endif  // HAVE_BAGL
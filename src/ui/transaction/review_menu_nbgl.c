@@ -16,29 +16,56 @@
  ********************************************************************************/
 #ifdef HAVE_NBGL
 #include <ux.h>
-#include "fmt.h"
+#include "format_cache.h"
+#include "text_writer.h"
+#include "global.h"
 #include "idle_menu.h"
 #include "review_menu.h"
 #include "nbgl_use_case.h"
 
 #define MAX_FIELDS_PER_PAGE 5
 
+// The values of the pairs point into the format cache, so it must hold a whole page
+_Static_assert(FORMAT_CACHE_SIZE >= MAX_FIELDS_PER_PAGE, "Format cache smaller than a page");
+
 // Globals
-static field_value_t txFieldValueStrings[MAX_FIELDS_PER_PAGE];
+static field_name_t txFieldNameStrings[MAX_FIELDS_PER_PAGE];
 static nbgl_contentTagValue_t pair;
 static nbgl_contentTagValueList_t pairList;
-static parseResult_t *transaction;
+static parseContext_t *transaction;
 static resultAction_t approval_menu_callback;
 
+// Each page of a long value is a pair, unless there are too many pages for the 8-bit
+// pair index. Every field is then a single pair, cut with "..." if it is too long.
+static bool paged;
+
+static uint8_t get_pair_count(parseContext_t *transaction_param) {
+    uint16_t item_count = get_display_item_count(transaction_param);
+
+    paged = item_count <= UINT8_MAX;
+    return paged ? item_count : get_field_count(transaction_param);
+}
+
 // function called by NBGL to get the pair indexed by "index"
 static nbgl_layoutTagValue_t *getPair(uint8_t index) {
     uint8_t arr_idx = index % MAX_FIELDS_PER_PAGE;
-    memset(&txFieldValueStrings[arr_idx], 0, sizeof(field_value_t));
-    // Format tag item string.
-    pair.item = (char *) resolve_field_name(&transaction->fields[index]);
-    // Format tag value string.
-    format_field(&transaction->fields[index], &txFieldValueStrings[arr_idx]);
-    pair.value = txFieldValueStrings[arr_idx].buf;
+    uint8_t field_index = index;
+    uint8_t page = WHOLE_FIELD;
+    if (paged) {
+        get_display_item(transaction, index, &field_index, &page);
+    }
+    // Format tag value string, unless it has been formatted recently.
+    const formattedField_t *entry =
+        get_formatted_field(&approval_strings.review.cache, transaction, field_index, page);
+    // Format tag item string, with the page of long values.
+    textWriter_t title;
+    writer_init(&title, txFieldNameStrings[arr_idx].buf, sizeof(field_name_t));
+    write_string(&title, resolve_field_name(get_field(transaction, field_index)));
+    if (entry->page_count > 1) {
+        write_page_number(&title, entry->page, entry->page_count);
+    }
+    pair.item = txFieldNameStrings[arr_idx].buf;
+    pair.value = entry->value.buf;
     PRINTF("Arr idx %d - Tag %d item : %s\nTag %d value : %s\n",
            arr_idx,
            index,
@@ -58,16 +85,17 @@ static void reviewChoice(bool confirm) {
     }
 }
 
-void display_review_menu(parseResult_t *transaction_param, resultAction_t callback) {
+void display_review_menu(parseContext_t *transaction_param, resultAction_t callback) {
     transaction = transaction_param;
     approval_menu_callback = callback;
 
     // Reset globals
-    memset(&txFieldValueStrings, 0, sizeof(txFieldValueStrings));
+    memset(&txFieldNameStrings, 0, sizeof(txFieldNameStrings));
     memset(&pair, 0, sizeof(pair));
+    format_cache_reset(&approval_strings.review.cache);
 
     pairList.pairs = NULL;
-    pairList.nbPairs = transaction->num_fields;
+    pairList.nbPairs = get_pair_count(transaction);
     pairList.nbMaxLinesForValue = 0;
     pairList.callback = getPair;
     pairList.startIndex = 0;
@@ -80,4 +108,12 @@ void display_review_menu(parseResult_t *transaction_param, resultAction_t callba
                        "Sign transaction?",
                        reviewChoice);
 }
+
+uint8_t get_review_screen_count(parseContext_t *transaction_param) {
+    uint8_t count = get_pair_count(transaction_param);
+
+    // The introduction, the pages of fields and the final sign page. This is an estimate,
+    // NBGL decides how many pairs fit on a page when it lays them out.
+    return 1 + (count + MAX_FIELDS_PER_PAGE - 1) / MAX_FIELDS_PER_PAGE + 1;
+}
 #endif  // HAVE_NBGL
@@ -0,0 +1,50 @@
+/*******************************************************************************
+ *   XRP Wallet
+ *   (c) 2020 Towo Labs
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+#include <string.h>
+
+#include "address_cache.h"
+#include "xrp_helpers.h"
+
+void address_cache_reset(addressCache_t *cache) {
+    memset(cache, 0, sizeof(addressCache_t));
+}
+
+const cachedAddress_t *get_encoded_address(addressCache_t *cache, const xrp_account_t *account) {
+    for (uint8_t i = 0; i < cache->count; ++i) {
+        if (memcmp(cache->entries[i].account.buf, account->buf, XRP_ACCOUNT_SIZE) == 0) {
+            return &cache->entries[i];
+        }
+    }
+
+    cachedAddress_t *entry = &cache->entries[cache->next];
+    cache->next = (cache->next + 1) % ADDRESS_CACHE_SIZE;
+    if (cache->count < ADDRESS_CACHE_SIZE) {
+        cache->count++;
+    }
+
+    xrp_address_t address;
+    memcpy(&entry->account, account, sizeof(xrp_account_t));
+    size_t length = xrp_public_key_to_encoded_base58(NULL, &entry->account, &address, 0);
+    if (length > MAX_CLASSIC_ADDRESS_LENGTH) {
+        length = 0;
+    }
+    memcpy(entry->address, address.buf, length);
+    entry->length = length;
+
+    return entry;
+}
@@ -0,0 +1,51 @@
+/*******************************************************************************
+ *   XRP Wallet
+ *   (c) 2020 Towo Labs
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+#ifndef LEDGER_APP_XRP_ADDRESSCACHE_H
+#define LEDGER_APP_XRP_ADDRESSCACHE_H
+
+#include <stdint.h>
+
+#include "fields.h"
+#include "limitations.h"
+
+// A classic address encodes 25 bytes (version, account and checksum) in at most 35 characters
+#define MAX_CLASSIC_ADDRESS_LENGTH 35
+
+typedef struct {
+    xrp_account_t account;
+    uint8_t length;
+    char address[MAX_CLASSIC_ADDRESS_LENGTH];  // Not NUL terminated
+} cachedAddress_t;
+
+// Classic addresses of the accounts encoded during the current transaction, since the
+// same account is often displayed several times (Account, Destination, issuers and path
+// steps) and each encoding hashes the account twice. The oldest entry is replaced on a
+// miss. An all zero cache is empty.
+typedef struct {
+    cachedAddress_t entries[ADDRESS_CACHE_SIZE];
+    uint8_t count;  // Number of valid entries
+    uint8_t next;   // Entry replaced on the next miss
+} addressCache_t;
+
+void address_cache_reset(addressCache_t *cache);
+
+// Encode the account as a classic address, unless it is cached. The entry stays valid
+// until ADDRESS_CACHE_SIZE other accounts have been encoded.
+const cachedAddress_t *get_encoded_address(addressCache_t *cache, const xrp_account_t *account);
+
+#endif  // LEDGER_APP_XRP_ADDRESSCACHE_H
@@ -32,49 +32,22 @@
 #define MANTISSA_MIN 1000000000000000
 #define MANTISSA_MAX 9999999999999999
 
-static void normalize(uint64_t *mantissa_param, int16_t *exponent_param) {
-    while (*mantissa_param > 0 && *mantissa_param % 10 == 0) {
-        *mantissa_param = *mantissa_param / 10;
-        (*exponent_param)++;
-    }
-}
-
-static int print_uint64_t(char *dst, uint16_t len, uint64_t value) {
-    uint16_t num_digits = 0, i;
-    uint64_t base = 1;
-
-    while (base <= value) {
-        base *= 10;
-        num_digits++;
-    }
-
-    if (num_digits > len - 1) {
-        return -1;
-    }
+// Longest issued currency amount, "-0." followed by 80 zeros and 16 digits
+#define MAX_DECIMAL_NUMBER_LEN 99
 
-    base /= 10;
-    for (i = 0; i < num_digits; i++) {
-        dst[i] = int_to_number_char((value / base) % 10);
-        base /= 10;
-    }
-
-    dst[i] = '\x00';
-
-    return 0;
-}
-
-static int parse_decimal_number(char *dst,
-                                size_t max_len,
+static int parse_decimal_number(textWriter_t *out,
                                 uint8_t sign,
                                 int16_t exponent,
                                 uint64_t mantissa) {
-    if (max_len < 100) {
+    char digits[MAX_DECIMAL_DIGITS];
+
+    if (out->capacity - out->length <= MAX_DECIMAL_NUMBER_LEN) {
         return -1;
     }
 
     // 0. Abort early if number matches special case for zero
     if (sign == 0 && exponent == 0 && mantissa == 0) {
-        dst[0] = '0';
+        write_char(out, '0');
         return 0;
     }
 
@@ -88,154 +61,133 @@ static int parse_decimal_number(char *dst,
 
     // 1. Add leading minus sign if number is negative
     if (sign == 0) {
-        dst[0] = '-';
-
-        dst++;
-        max_len--;
+        write_char(out, '-');
     }
 
-    // 2. Normalize mantissa by removing redundant trailing zeros
-    normalize(&mantissa, &exponent);
+    // 2. Get the mantissa without its redundant trailing zeros, which are moved
+    //    to the exponent
+    size_t len = decimal_digits_normalized(mantissa, &exponent, digits);
 
-    // 3. Print the entire mantissa to our buffer
-    if (print_uint64_t(dst, max_len, mantissa) != 0) {
-        return -1;
-    }
-
-    // 4. Store the length of our normalized mantissa
-    size_t len = strlen(dst);
-
-    // 5. Calculate the position of the decimal point relative to dst
+    // 3. Calculate the position of the decimal point relative to the digits
     int16_t decimal_pos = len + exponent;
 
     if (exponent >= 0) {
         // Exponent is positive, "multiply" the mantissa (decimalPos not needed)
-        memset(dst + len, '0', exponent);
+        write_chars(out, digits, len);
+        write_repeat(out, '0', exponent);
     } else if (decimal_pos > 0) {
-        // Decimal position is within our bounds, make room for it and add it
-        memmove(dst + decimal_pos + 1, dst + decimal_pos, len);
-        dst[decimal_pos] = '.';
+        // Decimal position is within the digits
+        write_chars(out, digits, decimal_pos);
+        write_char(out, '.');
+        write_chars(out, digits + decimal_pos, len - decimal_pos);
     } else {
-        // Decimal position is outside our bounds, move the mantissa to make
-        // sure that the decimal point can fit within the new bounds
-        memmove(dst - decimal_pos + 2, dst, len);
-        memset(dst, '0', -decimal_pos + 2);
-        dst[1] = '.';
+        // Decimal position is before the digits, add leading zeros
+        write_string(out, "0.");
+        write_repeat(out, '0', -decimal_pos);
+        write_chars(out, digits, len);
     }
 
     return 0;
 }
 
-static int format_xrp(uint64_t amount, field_value_t *dst) {
+static int format_xrp(uint64_t amount, textWriter_t *out) {
+    char buf[32];
+
     if (!(amount & 0x4000000000000000)) {
         return -1;
     }
 
     amount ^= 0x4000000000000000;
-    if (xrp_print_amount(amount, dst->buf, sizeof(dst->buf)) != 0) {
+    if (xrp_print_amount(amount, buf, sizeof(buf)) != 0) {
         return -1;
     }
+    write_string(out, buf);
 
     return 0;
 }
 
-static bool is_all_zeros(const uint8_t *data, uint8_t length) {
-    for (size_t i = 0; i < length; ++i) {
-        if (data[i] != 0) {
-            return false;
-        }
-    }
-
-    return true;
-}
-
 static bool has_non_standard_currency_internal(const uint8_t *currency_data) {
     return currency_data[0] != 0x00;
 }
 
-bool has_non_standard_currency(field_t *field) {
-    return has_non_standard_currency_internal(&field->data.ptr[8]);
+bool has_non_standard_currency(parseContext_t *context, field_t *field) {
+    return has_non_standard_currency_internal(&field_data(context, field)[8]);
+}
+
+// Three letter code, which stops at a NUL byte like the strings it used to be copied to
+static void write_currency_code(textWriter_t *out, const uint8_t *code) {
+    write_chars(out, (const char *) code, strnlen((const char *) code, 3));
 }
 
-static void format_standard_currency(uint8_t *currency_data, char *buf, size_t size) {
+static void format_standard_currency(uint8_t *currency_data, textWriter_t *out) {
     if (has_non_standard_currency_internal(currency_data)) {
     } else if (is_all_zeros(currency_data, 20)) {
         // Special case for XRP currency
-        strncpy(buf, "XRP", size);
+        write_string(out, "XRP");
     } else {
         // Standard currency code
-        memcpy(buf, &currency_data[12], 3);
+        write_currency_code(out, &currency_data[12]);
     }
 }
 
-static void format_non_standard_currency(xrp_currency_t *currency, field_value_t *dst) {
+static void format_non_standard_currency(xrp_currency_t *currency, textWriter_t *out) {
     if (has_non_standard_currency_internal(currency->buf)) {
         // Nonstandard currency code
         bool contains_only_ascii = is_purely_ascii(currency->buf, sizeof(currency->buf), true);
         if (contains_only_ascii && currency->buf[sizeof(currency->buf) - 1] == '\x00' &&
             strstr((char *) currency->buf, "XRP")) {
-            memcpy(dst->buf, currency->buf, 20);
+            write_string(out, (const char *) currency->buf);
         } else {
-            read_hex(dst->buf, sizeof(dst->buf), currency->buf, sizeof(currency->buf));
+            write_hex(out, currency->buf, sizeof(currency->buf));
         }
     } else if (is_all_zeros(currency->buf, sizeof(currency->buf))) {
         // Special case for XRP currency
-        strncpy(dst->buf, "XRP", sizeof(dst->buf));
+        write_string(out, "XRP");
     } else {
         // Standard currency code
-        memcpy(dst->buf, &currency->buf[12], 3);
+        write_currency_code(out, &currency->buf[12]);
     }
 }
 
-static int format_issued_currency(uint64_t value, char *buf, size_t size) {
+static int format_issued_currency(uint64_t value, textWriter_t *out) {
     uint8_t sign = (uint8_t) ((value >> 62u) & 0x01u);
     int16_t exponent = (int16_t) (((value >> 54u) & 0xFFu) - 97);
     uint64_t mantissa = value & 0x3FFFFFFFFFFFFFu;
-    size_t len = strlen(buf);
-    char *p;
-
-    p = buf + len;
-    size -= len;
-
-    if (size == 0) {
-        return -1;
-    }
 
-    if (len > 0) {
+    if (out->length > 0) {
         // Only add space if a currency was printed
-        *p++ = ' ';
-        size--;
+        write_char(out, ' ');
     }
 
     if (value << 1u == 0) {
         // Special case for the value zero
-        *p++ = '0';
-        size--;
+        write_char(out, '0');
         return 0;
     }
 
-    return parse_decimal_number(p, size, sign, exponent, mantissa);
+    return parse_decimal_number(out, sign, exponent, mantissa);
 }
 
-void amount_formatter(field_t *field, field_value_t *dst) {
-    uint64_t value = read_unsigned64(field->data.ptr);
+void amount_formatter(parseContext_t *context, field_t *field, textWriter_t *out) {
+    uint64_t value = read_unsigned64(field_data(context, field));
     int error;
 
     if (field->length == XRP_AMOUNT_LEN) {
-        error = format_xrp(value, dst);
+        error = format_xrp(value, out);
     } else if (field->length == ISSUED_CURRENCY_LEN) {
-        format_standard_currency(&field->data.ptr[8], dst->buf, sizeof(dst->buf));
-        error = format_issued_currency(value, dst->buf, sizeof(dst->buf));
+        format_standard_currency(&field_data(context, field)[8], out);
+        error = format_issued_currency(value, out);
     } else {
         error = 1;
     }
 
     if (error) {
-        strncpy(dst->buf, "Invalid amount!", sizeof(dst->buf));
+        writer_reset(out);
+        write_string(out, "Invalid amount!");
     }
 }
 
-void currency_formatter(field_t *field, field_value_t *dst) {
-    xrp_currency_t *currency = (xrp_currency_t *) field->data.ptr;
-    format_non_standard_currency(currency, dst);
+void currency_formatter(parseContext_t *context, field_t *field, textWriter_t *out) {
+    xrp_currency_t *currency = (xrp_currency_t *) field_data(context, field);
+    format_non_standard_currency(currency, out);
 }
@@ -21,11 +21,12 @@
 
 #include <stdbool.h>
 #include "fields.h"
+#include "text_writer.h"
 
-void amount_formatter(field_t* field, field_value_t* dst);
-void currency_formatter(field_t* field, field_value_t* dst);
+void amount_formatter(parseContext_t* context, field_t* field, textWriter_t* out);
+void currency_formatter(parseContext_t* context, field_t* field, textWriter_t* out);
 
-bool has_non_standard_currency(field_t* field);
+bool has_non_standard_currency(parseContext_t* context, field_t* field);
 
 #define XRP_AMOUNT_LEN      8
 #define ISSUED_CURRENCY_LEN 48
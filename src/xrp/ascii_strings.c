@@ -16,26 +16,120 @@
  *  limitations under the License.
  ********************************************************************************/
 
+#include <stdint.h>
+#include <string.h>
+
 #include "ascii_strings.h"
 
-bool is_purely_ascii(const uint8_t *data, uint16_t length, bool allow_suffix) {
-    bool tracking_suffix = false;
+// The checks below work on 32-bit words, four bytes at a time. The words are loaded from
+// aligned addresses, which Cortex-M0 requires, and the bytes before the first aligned
+// address and after the last whole word are checked one at a time.
+#define ONES  0x01010101u
+#define HIGHS 0x80808080u
+
+static inline uint32_t load_aligned_word(const uint8_t *data) {
+    uint32_t word;
+    memcpy(&word, __builtin_assume_aligned(data, 4), sizeof(word));
+    return word;
+}
+
+static inline size_t unaligned_head(const uint8_t *data, size_t length) {
+    size_t head = (4 - ((uintptr_t) data & 3)) & 3;
+    return head < length ? head : length;
+}
+
+static inline bool is_printable(uint8_t c) {
+    return c >= 32 && c <= 126;
+}
+
+// Nonzero if a byte of the word is below 32 or above 126. Both tests are exact for
+// bounds below 128, the carries they propagate only matter once a byte has matched.
+static inline uint32_t has_non_printable(uint32_t word) {
+    uint32_t below = (word - ONES * 32) & ~word;
+    uint32_t above = (word + ONES * (127 - 126)) | word;
+    return (below | above) & HIGHS;
+}
+
+static bool is_printable_range(const uint8_t *data, size_t length) {
+    size_t i = unaligned_head(data, length);
 
-    for (uint16_t i = 0; i < length; ++i) {
-        if (tracking_suffix && data[i] != 0) {
-            // The suffix can only contain null bytes
+    for (size_t j = 0; j < i; ++j) {
+        if (!is_printable(data[j])) {
             return false;
         }
+    }
 
-        if (data[i] == 0 && i > 0 && allow_suffix) {
-            tracking_suffix = true;
-            continue;
-        }
+    uint32_t mismatch = 0;
+    for (; i + 4 <= length; i += 4) {
+        mismatch |= has_non_printable(load_aligned_word(data + i));
+    }
+    if (mismatch != 0) {
+        return false;
+    }
 
-        if (data[i] < 32 || data[i] > 126) {
+    for (; i < length; ++i) {
+        if (!is_printable(data[i])) {
             return false;
         }
     }
 
     return true;
 }
+
+static size_t find_zero(const uint8_t *data, size_t length) {
+    size_t i = unaligned_head(data, length);
+
+    for (size_t j = 0; j < i; ++j) {
+        if (data[j] == 0) {
+            return j;
+        }
+    }
+
+    for (; i + 4 <= length; i += 4) {
+        uint32_t word = load_aligned_word(data + i);
+        if (((word - ONES) & ~word & HIGHS) != 0) {
+            break;
+        }
+    }
+
+    for (; i < length; ++i) {
+        if (data[i] == 0) {
+            return i;
+        }
+    }
+
+    return length;
+}
+
+bool is_purely_ascii(const uint8_t *data, uint16_t length, bool allow_suffix) {
+    if (!allow_suffix) {
+        return is_printable_range(data, length);
+    }
+
+    // The suffix starts at the first null byte, which can't be the first byte
+    size_t suffix = find_zero(data, length);
+    if (suffix == 0 && length > 0) {
+        return false;
+    }
+
+    return is_printable_range(data, suffix) && is_all_zeros(data + suffix, length - suffix);
+}
+
+bool is_all_zeros(const uint8_t *data, size_t length) {
+    size_t i = unaligned_head(data, length);
+    uint32_t bits = 0;
+
+    for (size_t j = 0; j < i; ++j) {
+        bits |= data[j];
+    }
+
+    for (; i + 4 <= length; i += 4) {
+        bits |= load_aligned_word(data + i);
+    }
+
+    for (; i < length; ++i) {
+        bits |= data[i];
+    }
+
+    return bits == 0;
+}
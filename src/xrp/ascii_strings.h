@@ -2,4 +2,7 @@
 
 #include "fields.h"
 
+// Printable ASCII (32 to 126), followed by a suffix of null bytes if allow_suffix is set
 bool is_purely_ascii(const uint8_t *data, uint16_t length, bool allow_suffix);
+
+bool is_all_zeros(const uint8_t *data, size_t length);
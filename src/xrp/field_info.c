@@ -0,0 +1,170 @@
+/*******************************************************************************
+ *   XRP Wallet
+ *   (c) 2020 Towo Labs
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+#include <os.h>
+
+#include "field_info.h"
+
+// Metadata of the known fields, which must be sorted by type and field code. The
+// first entry is used for unknown fields.
+static const fieldInfo_t field_infos[] = {
+    {0, 0, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_NONE, "Unknown"},
+    {STI_UINT16, XRP_UINT16_TRANSACTION_TYPE, FORMAT_TRANSACTION_TYPE, PRIORITY_TRANSACTION_TYPE,
+     0, SCHEMA_COMMON, "Transaction Type"},
+    {STI_UINT16, 3, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_NONE, "Signer Weight"},
+    {STI_UINT16, 4, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_TRANSFER_FEE, "Transfer Fee"},
+    {STI_UINT16, 5, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_NONE, "Trading Fee"},
+    {STI_UINT32, 1, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_COMMON, "Network ID"},
+    {STI_UINT32, XRP_UINT32_FLAGS, FORMAT_FLAGS, PRIORITY_DEFAULT, 0, SCHEMA_COMMON, "Flags"},
+    {STI_UINT32, 3, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_COMMON, "Source Tag"},
+    {STI_UINT32, XRP_UINT32_SEQUENCE, FORMAT_DEFAULT, PRIORITY_DEFAULT, FIELD_HIDDEN,
+     SCHEMA_COMMON, "Sequence"},
+    {STI_UINT32, XRP_UINT32_EXPIRATION, FORMAT_TIME, PRIORITY_DEFAULT, 0, SCHEMA_EXPIRATION,
+     "Expiration"},
+    {STI_UINT32, XRP_UINT32_TRANSFER_RATE, FORMAT_PERCENTAGE, PRIORITY_DEFAULT, 0,
+     SCHEMA_TRANSFER_RATE, "Transfer Rate"},
+    {STI_UINT32, 12, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_WALLET_SIZE, "Wallet Size"},
+    {STI_UINT32, 14, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_DESTINATION_TAG,
+     "Destination Tag"},
+    {STI_UINT32, XRP_UINT32_QUALITY_IN, FORMAT_PERCENTAGE, PRIORITY_DEFAULT, 0, SCHEMA_QUALITY_IN,
+     "Quality In"},
+    {STI_UINT32, XRP_UINT32_QUALITY_OUT, FORMAT_PERCENTAGE, PRIORITY_DEFAULT, 0,
+     SCHEMA_QUALITY_OUT, "Quality Out"},
+    {STI_UINT32, 25, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_OFFER_SEQUENCE, "Offer Sequence"},
+    {STI_UINT32, XRP_UINT32_LAST_LEDGER_SEQUENCE, FORMAT_DEFAULT, PRIORITY_DEFAULT, FIELD_HIDDEN,
+     SCHEMA_COMMON, "Last Ledger Sequence"},
+    {STI_UINT32, XRP_UINT32_SET_FLAG, FORMAT_FLAGS, PRIORITY_DEFAULT, 0, SCHEMA_SET_FLAG,
+     "Set Flag"},
+    {STI_UINT32, XRP_UINT32_CLEAR_FLAG, FORMAT_FLAGS, PRIORITY_DEFAULT, 0, SCHEMA_CLEAR_FLAG,
+     "Clear Flag"},
+    {STI_UINT32, 35, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_SIGNER_QUORUM, "Signer Quorum"},
+    {STI_UINT32, XRP_UINT32_CANCEL_AFTER, FORMAT_TIME, PRIORITY_DEFAULT, 0, SCHEMA_CANCEL_AFTER,
+     "Cancel After"},
+    {STI_UINT32, XRP_UINT32_FINISH_AFTER, FORMAT_TIME, PRIORITY_DEFAULT, 0, SCHEMA_FINISH_AFTER,
+     "Finish After"},
+    {STI_UINT32, XRP_UINT32_SETTLE_DELAY, FORMAT_TIME_DELTA, PRIORITY_DEFAULT, 0,
+     SCHEMA_SETTLE_DELAY, "Settle Delay"},
+    {STI_UINT32, 40, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_TICKET_COUNT, "Ticket Count"},
+    {STI_UINT32, 41, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_COMMON, "Ticket Sequence"},
+    {STI_UINT32, 42, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_NFTOKEN_TAXON, "Token Taxon"},
+    {STI_HASH128, 1, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_EMAIL_HASH, "Email Hash"},
+    {STI_HASH256, 5, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_NONE, "Previous Txn ID"},
+    {STI_HASH256, 7, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_WALLET_LOCATOR, "Wallet Locator"},
+    {STI_HASH256, 9, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_COMMON, "Account Txn ID"},
+    {STI_HASH256, 10, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_NFTOKEN_ID, "NFToken ID"},
+    {STI_HASH256, 17, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_INVOICE_ID, "Invoice ID"},
+    {STI_HASH256, 20, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_NONE, "Ticket ID"},
+    {STI_HASH256, 22, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_CHANNEL, "Channel"},
+    {STI_HASH256, 24, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_CHECK_ID, "Check ID"},
+    {STI_HASH256, 28, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_NFTOKEN_BUY_OFFER, "Buy Offer"},
+    {STI_HASH256, 29, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_NFTOKEN_SELL_OFFER, "Sell Offer"},
+    {STI_AMOUNT, XRP_UINT64_AMOUNT, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_AMOUNT, "Amount"},
+    {STI_AMOUNT, 2, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_BALANCE, "Balance"},
+    {STI_AMOUNT, 3, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_LIMIT_AMOUNT, "Limit Amount"},
+    {STI_AMOUNT, 4, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_TAKER_PAYS, "Taker Pays"},
+    {STI_AMOUNT, 5, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_TAKER_GETS, "Taker Gets"},
+    {STI_AMOUNT, XRP_UINT64_FEE, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_COMMON, "Fee"},
+    {STI_AMOUNT, 9, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_SEND_MAX, "Send Max"},
+    {STI_AMOUNT, 10, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_DELIVER_MIN, "Deliver Min"},
+    {STI_AMOUNT, 11, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_NONE, "Amount 2"},
+    {STI_AMOUNT, 19, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_NFTOKEN_BROKER_FEE, "Broker Fee"},
+    {STI_VL, 1, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_PUBLIC_KEY, "Public Key"},
+    {STI_VL, 2, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_MESSAGE_KEY, "Message Key"},
+    {STI_VL, XRP_VL_SIGNING_PUB_KEY, FORMAT_DEFAULT, PRIORITY_DEFAULT, FIELD_HIDDEN,
+     SCHEMA_COMMON, "Sig.PubKey"},
+    {STI_VL, 4, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_COMMON, "Txn Sig."},
+    {STI_VL, 5, FORMAT_ASCII_OR_HEX, PRIORITY_DEFAULT, 0, SCHEMA_URI, "URI"},
+    {STI_VL, 6, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_SIGNATURE, "Signature"},
+    {STI_VL, XRP_VL_DOMAIN, FORMAT_STRING, PRIORITY_DEFAULT, 0, SCHEMA_DOMAIN, "Domain"},
+    {STI_VL, XRP_VL_MEMO_TYPE, FORMAT_STRING, PRIORITY_DEFAULT, 0, SCHEMA_NONE, "Memo Type"},
+    {STI_VL, XRP_VL_MEMO_DATA, FORMAT_ASCII_OR_HEX, PRIORITY_DEFAULT, 0, SCHEMA_NONE, "Memo Data"},
+    {STI_VL, XRP_VL_MEMO_FORMAT, FORMAT_STRING, PRIORITY_DEFAULT, 0, SCHEMA_NONE, "Memo Fmt"},
+    {STI_VL, 16, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_FULFILLMENT, "Fulfillment"},
+    {STI_VL, 17, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_CONDITION, "Condition"},
+    {STI_ACCOUNT, XRP_ACCOUNT_ACCOUNT, FORMAT_DEFAULT, PRIORITY_ACCOUNT, 0, SCHEMA_COMMON,
+     "Account"},
+    {STI_ACCOUNT, 2, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_OWNER, "Owner"},
+    {STI_ACCOUNT, XRP_ACCOUNT_DESTINATION, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0,
+     SCHEMA_DESTINATION, "Destination"},
+    {STI_ACCOUNT, XRP_ACCOUNT_ISSUER, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_ISSUER, "Issuer"},
+    {STI_ACCOUNT, 5, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_AUTHORIZE, "Authorize"},
+    {STI_ACCOUNT, 6, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_UNAUTHORIZE, "Unauthorize"},
+    {STI_ACCOUNT, XRP_ACCOUNT_REGULAR_KEY, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0,
+     SCHEMA_REGULAR_KEY, "Regular Key"},
+    {STI_ACCOUNT, 9, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_NFTOKEN_MINTER, "NFToken Minter"},
+    {STI_OBJECT, 10, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_NONE, "Memo"},
+    {STI_OBJECT, 11, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_NONE, "Signer Entry"},
+    {STI_OBJECT, 16, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_NONE, "Signer"},
+    {STI_ARRAY, 3, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_COMMON, "Signers"},
+    {STI_ARRAY, 4, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_SIGNER_ENTRIES, "Signer Entries"},
+    {STI_ARRAY, 9, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_COMMON, "Memos"},
+    {STI_UINT8, 16, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_TICK_SIZE, "Tick Size"},
+    {STI_PATHSET, 1, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_PATHS, "Paths"},
+    {STI_VECTOR256, 4, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_NFTOKEN_OFFERS,
+     "NFToken Offers"},
+    {STI_CURRENCY, XRP_CURRENCY_CURRENCY, FORMAT_DEFAULT, PRIORITY_DEFAULT, 0, SCHEMA_NONE,
+     "Currency"},
+};
+
+#define FIELD_INFO_COUNT (sizeof(field_infos) / sizeof(field_infos[0]))
+
+// The index of the entry is stored in field_t
+_Static_assert(FIELD_INFO_COUNT <= 256, "too many field infos");
+
+static uint16_t field_info_key(uint8_t data_type, uint8_t id) {
+    return data_type << 8u | id;
+}
+
+void set_field_info(field_t *field) {
+    uint16_t key = field_info_key(field->data_type, field->id);
+    uint16_t low = 1;
+    uint16_t high = FIELD_INFO_COUNT;
+
+    field->info = 0;
+    while (low < high) {
+        uint16_t middle = (low + high) / 2;
+        const fieldInfo_t *info = &field_infos[middle];
+        uint16_t middle_key = field_info_key(info->data_type, info->id);
+
+        if (middle_key == key) {
+            field->info = middle;
+            return;
+        } else if (middle_key < key) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+}
+
+const fieldInfo_t *get_field_info(const field_t *field) {
+    if (field->info >= FIELD_INFO_COUNT) {
+        return &field_infos[0];
+    }
+
+    return &field_infos[field->info];
+}
+
+const fieldInfo_t *get_schema_field_info(uint8_t schema) {
+    for (uint16_t i = 1; i < FIELD_INFO_COUNT; ++i) {
+        if (field_infos[i].schema == schema) {
+            return &field_infos[i];
+        }
+    }
+
+    return &field_infos[0];
+}
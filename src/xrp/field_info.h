@@ -0,0 +1,121 @@
+/*******************************************************************************
+ *   XRP Wallet
+ *   (c) 2020 Towo Labs
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+#ifndef LEDGER_APP_XRP_FIELD_INFO_H
+#define LEDGER_APP_XRP_FIELD_INFO_H
+
+#include "fields.h"
+
+// How a field value is displayed, on top of what its type implies
+typedef enum {
+    FORMAT_DEFAULT = 0,
+    FORMAT_TRANSACTION_TYPE,
+    FORMAT_FLAGS,
+    FORMAT_TIME,
+    FORMAT_TIME_DELTA,
+    FORMAT_PERCENTAGE,
+    FORMAT_STRING,        // Blob displayed as a string
+    FORMAT_ASCII_OR_HEX,  // Blob displayed as a string when it is purely ASCII
+} fieldFormat_t;
+
+// Display priorities, see field_sort.c
+#define PRIORITY_TRANSACTION_TYPE 0
+#define PRIORITY_ACCOUNT          1
+#define PRIORITY_DEFAULT          2
+
+// Transaction specific fields, which are checked against the schema of the
+// transaction type (see transaction_types.c). Common fields are allowed in every
+// transaction, while other fields are never allowed at the top level.
+typedef enum {
+    SCHEMA_AMOUNT,
+    SCHEMA_DESTINATION,
+    SCHEMA_DESTINATION_TAG,
+    SCHEMA_INVOICE_ID,
+    SCHEMA_SEND_MAX,
+    SCHEMA_DELIVER_MIN,
+    SCHEMA_PATHS,
+    SCHEMA_REGULAR_KEY,
+    SCHEMA_FINISH_AFTER,
+    SCHEMA_CANCEL_AFTER,
+    SCHEMA_CONDITION,
+    SCHEMA_FULFILLMENT,
+    SCHEMA_OWNER,
+    SCHEMA_OFFER_SEQUENCE,
+    SCHEMA_SET_FLAG,
+    SCHEMA_CLEAR_FLAG,
+    SCHEMA_DOMAIN,
+    SCHEMA_EMAIL_HASH,
+    SCHEMA_MESSAGE_KEY,
+    SCHEMA_TRANSFER_RATE,
+    SCHEMA_TICK_SIZE,
+    SCHEMA_WALLET_LOCATOR,
+    SCHEMA_WALLET_SIZE,
+    SCHEMA_NFTOKEN_MINTER,
+    SCHEMA_EXPIRATION,
+    SCHEMA_TAKER_PAYS,
+    SCHEMA_TAKER_GETS,
+    SCHEMA_SIGNER_QUORUM,
+    SCHEMA_SIGNER_ENTRIES,
+    SCHEMA_SETTLE_DELAY,
+    SCHEMA_PUBLIC_KEY,
+    SCHEMA_CHANNEL,
+    SCHEMA_BALANCE,
+    SCHEMA_SIGNATURE,
+    SCHEMA_CHECK_ID,
+    SCHEMA_AUTHORIZE,
+    SCHEMA_UNAUTHORIZE,
+    SCHEMA_LIMIT_AMOUNT,
+    SCHEMA_QUALITY_IN,
+    SCHEMA_QUALITY_OUT,
+    SCHEMA_TICKET_COUNT,
+    SCHEMA_NFTOKEN_TAXON,
+    SCHEMA_TRANSFER_FEE,
+    SCHEMA_URI,
+    SCHEMA_ISSUER,
+    SCHEMA_NFTOKEN_ID,
+    SCHEMA_NFTOKEN_OFFERS,
+    SCHEMA_NFTOKEN_BUY_OFFER,
+    SCHEMA_NFTOKEN_SELL_OFFER,
+    SCHEMA_NFTOKEN_BROKER_FEE,
+    SCHEMA_FIELD_COUNT,
+    SCHEMA_COMMON = 0xFE,
+    SCHEMA_NONE = 0xFF,
+} schemaField_t;
+
+_Static_assert(SCHEMA_FIELD_COUNT <= 64, "schema fields don't fit in a bitmask");
+
+// Field attributes
+#define FIELD_HIDDEN 0x01  // Never displayed at the top level
+
+typedef struct {
+    uint8_t data_type;  // field_type_t
+    uint8_t id;
+    uint8_t format;    // fieldFormat_t
+    uint8_t priority;  // Only applies at the top level
+    uint8_t attributes;
+    uint8_t schema;  // schemaField_t
+    const char *name;
+} fieldInfo_t;
+
+// Look up the metadata of the field type and code, which is stored in field->info
+void set_field_info(field_t *field);
+const fieldInfo_t *get_field_info(const field_t *field);
+
+// Find the field that is checked as the given schemaField_t, only used on errors
+const fieldInfo_t *get_schema_field_info(uint8_t schema);
+
+#endif  // LEDGER_APP_XRP_FIELD_INFO_H
@@ -15,42 +15,47 @@
  *  limitations under the License.
  ********************************************************************************/
 
-#include <string.h>
-
 #include "field_sort.h"
-#include "transaction_types.h"
+#include "field_info.h"
 
 uint8_t get_priority_score(field_t *field) {
-    if (is_transaction_type_field(field)) {
-        return 0;
-    }
-
-    if (is_normal_account_field(field)) {
-        return 1;
+    if (field->array_info.type != 0) {
+        return PRIORITY_DEFAULT;
     }
 
-    return 2;
-}
-
-bool is_preceding(field_t *field, field_t *other_field) {
-    return get_priority_score(field) < get_priority_score(other_field);
+    return get_field_info(field)->priority;
 }
 
-void swap_fields(parseResult_t *result, uint8_t idx1, uint8_t idx2) {
-    field_t buffer_field;
-    memcpy(&buffer_field, &result->fields[idx1], sizeof(field_t));
-    memcpy(&result->fields[idx1], &result->fields[idx2], sizeof(field_t));
-    memcpy(&result->fields[idx2], &buffer_field, sizeof(field_t));
+static void swap_fields(parseResult_t *result, uint8_t idx1, uint8_t idx2) {
+    field_t buffer_field = result->fields[idx1];
+    result->fields[idx1] = result->fields[idx2];
+    result->fields[idx2] = buffer_field;
 }
 
+// Stable counting sort on the priority score, which only has PRIORITY_COUNT values
 void sort_fields(parseResult_t *result) {
-    for (uint8_t i = 0; i < result->num_fields - 1; ++i) {
-        field_t *cur_field = &result->fields[i];
-        field_t *next_field = &result->fields[i + 1];
+    uint8_t destination[RESULT_FIELD_COUNT];
+    uint8_t bucket_start[PRIORITY_COUNT] = {0};
+
+    // Count the fields of each priority, the destination temporarily holds the score
+    for (uint8_t i = 0; i < result->num_fields; ++i) {
+        destination[i] = get_priority_score(&result->fields[i]);
+        for (uint8_t priority = destination[i] + 1; priority < PRIORITY_COUNT; ++priority) {
+            bucket_start[priority]++;
+        }
+    }
+
+    for (uint8_t i = 0; i < result->num_fields; ++i) {
+        destination[i] = bucket_start[destination[i]]++;
+    }
 
-        if (is_preceding(next_field, cur_field) && !is_preceding(cur_field, next_field)) {
-            swap_fields(result, i, i + 1);
-            i = MAX(0, i - 1) - 1;  // Start next iteration at i - 1 or 0, whatever is largest
+    // Apply the permutation in place, every swap moves a field to its final position
+    for (uint8_t i = 0; i < result->num_fields; ++i) {
+        while (destination[i] != i) {
+            uint8_t j = destination[i];
+            swap_fields(result, i, j);
+            destination[i] = destination[j];
+            destination[j] = j;
         }
     }
 }
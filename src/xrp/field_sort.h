@@ -20,6 +20,11 @@
 
 #include "xrp_parse.h"
 
+// Fields are displayed by increasing priority score: the transaction type, the
+// account and then all other fields in parsing order
+#define PRIORITY_COUNT 3
+
+uint8_t get_priority_score(field_t *field);
 void sort_fields(parseResult_t *result);
 
 #endif  // LEDGER_APP_XRP_FIELDSORT_H
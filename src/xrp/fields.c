@@ -17,228 +17,47 @@
 
 #include <string.h>
 
+#include "os.h"
+
 #include "fields.h"
+#include "field_info.h"
 #include "flags.h"
 #include "common.h"
+#include "readers.h"
+#include "xrp_parse.h"
 
-#define HIDE(t, i) \
-    if (field->data_type == (t) && field->id == (i) && field->array_info.type == 0) return true
-
-bool is_normal_account_field(field_t *field) {
-    return field->data_type == STI_ACCOUNT && field->id == XRP_ACCOUNT_ACCOUNT &&
-           field->array_info.type == 0;
+uint8_t *field_data(const parseContext_t *context, const field_t *field) {
+    return context->data + field->offset;
 }
 
-const char *resolve_field_name(field_t *field) {
-    if (field->data_type == STI_UINT16) {
-        switch (field->id) {
-            case 2:
-                return "Transaction Type";
-            case 3:
-                return "Signer Weight";
-        }
-    }
-
-    if (field->data_type == STI_UINT32) {
-        switch (field->id) {
-            // 32-bit integers
-            case 2:
-                return "Flags";
-            case 3:
-                return "Source Tag";
-            case 4:
-                return "Sequence";
-            case 10:
-                return "Expiration";
-            case 11:
-                return "Transfer Rate";
-            case 12:
-                return "Wallet Size";
-            case 14:
-                return "Destination Tag";
-            case 20:
-                return "Quality In";
-            case 21:
-                return "Quality Out";
-            case 25:
-                return "Offer Sequence";
-            case 27:
-                return "Last Ledger Sequence";
-            case 33:
-                return "Set Flag";
-            case 34:
-                return "Clear Flag";
-            case 35:
-                return "Signer Quorum";
-            case 36:
-                return "Cancel After";
-            case 37:
-                return "Finish After";
-            case 39:
-                return "Settle Delay";
-        }
-    }
-
-    if (field->data_type == STI_HASH128) {
-        switch (field->id) {
-            case 1:
-                return "Email Hash";
-        }
-    }
-
-    if (field->data_type == STI_HASH256) {
-        switch (field->id) {
-            // 256-bit
-            case 5:
-                return "Previous Txn ID";
-            case 7:
-                return "Wallet Locator";
-            case 9:
-                return "Account Txn ID";
-            case 17:
-                return "Invoice ID";
-            case 20:
-                return "Ticket ID";
-            case 22:
-                return "Channel";
-            case 24:
-                return "Check ID";
-        }
-    }
-
-    if (field->data_type == STI_AMOUNT) {
-        switch (field->id) {
-            // currency amount
-            case 1:
-                return "Amount";
-            case 2:
-                return "Balance";
-            case 3:
-                return "Limit Amount";
-            case 4:
-                return "Taker Pays";
-            case 5:
-                return "Taker Gets";
-            case 8:
-                return "Fee";
-            case 9:
-                return "Send Max";
-            case 10:
-                return "Deliver Min";
-        }
-    }
-
-    if (field->data_type == STI_VL) {
-        switch (field->id) {
-            // variable length (common)
-            case 1:
-                return "Public Key";
-            case 3:
-                return "Sig.PubKey";
-            case 6:
-                return "Signature";
-            case 2:
-                return "Message Key";
-            case 4:
-                return "Txn Sig.";
-            case 7:
-                return "Domain";
-            case 12:
-                return "Memo Type";
-            case 13:
-                return "Memo Data";
-            case 14:
-                return "Memo Fmt";
-            case 16:
-                return "Fulfillment";
-            case 17:
-                return "Condition";
-        }
-    }
-
-    if (field->data_type == STI_ACCOUNT) {
-        switch (field->id) {
-            case 1:
-                return "Account";
-            case 2:
-                return "Owner";
-            case 3:
-                return "Destination";
-            case 4:
-                return "Issuer";
-            case 5:
-                return "Authorize";
-            case 6:
-                return "Unauthorize";
-            case 8:
-                return "Regular Key";
-        }
-    }
-
-    if (field->data_type == STI_OBJECT) {
-        switch (field->id) {
-            // inner object
-            // OBJECT/1 is reserved for end of object
-            case 10:
-                return "Memo";
-            case 11:
-                return "Signer Entry";
-            case 16:
-                return "Signer";
-        }
-    }
-
-    if (field->data_type == STI_ARRAY) {
-        switch (field->id) {
-            // array of objects
-            // ARRAY/1 is reserved for end of array
-            case 3:
-                return "Signers";
-            case 4:
-                return "Signer Entries";
-            case 9:
-                return "Memos";
-        }
-    }
-
-    if (field->data_type == STI_UINT8) {
-        switch (field->id) {
-            // 8-bit integers
-            case 16:
-                return "Tick Size";
-        }
-    }
-
-    if (field->data_type == STI_PATHSET) {
-        switch (field->id) {
-            case 1:
-                return "Paths";
-        }
-    }
+uint8_t field_u8(const parseContext_t *context, const field_t *field) {
+    return field_data(context, field)[0];
+}
 
-    if (field->data_type == STI_CURRENCY) {
-        switch (field->id) {
-            case 1:
-                return "Currency";
-        }
-    }
+uint16_t field_u16(const parseContext_t *context, const field_t *field) {
+    return read_unsigned16(field_data(context, field));
+}
 
-    // Default case
-    return "Unknown";
+uint32_t field_u32(const parseContext_t *context, const field_t *field) {
+    return read_unsigned32(field_data(context, field));
 }
 
-bool is_field_hidden(field_t *field) {
-    HIDE(STI_UINT32, XRP_UINT32_SEQUENCE);
-    HIDE(STI_UINT32, XRP_UINT32_LAST_LEDGER_SEQUENCE);
-    HIDE(STI_VL, XRP_VL_SIGNING_PUB_KEY);
+const char *resolve_field_name(field_t *field) {
+    return (const char *) PIC(get_field_info(field)->name);
+}
 
+bool is_field_hidden(parseContext_t *context, field_t *field) {
     if (field->data_type == STI_ARRAY || field->data_type == STI_OBJECT ||
         field->data_type == STI_PATHSET) {
         // Field is only used to instruct parsing code how to handle following fields: don't show
         return true;
     }
 
-    if (is_flag_hidden(field)) {
+    if ((get_field_info(field)->attributes & FIELD_HIDDEN) && field->array_info.type == 0) {
+        return true;
+    }
+
+    if (is_flag_hidden(context, field)) {
         return true;
     }
 
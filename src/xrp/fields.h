@@ -23,6 +23,10 @@
 
 #include "limitations.h"
 
+// Defined in xrp_parse.h, which needs the field types below. Field values are read from
+// the transaction data of the context.
+typedef struct parseContext_t parseContext_t;
+
 typedef enum {
     // Normal field types
     STI_UINT16 = 0x01,
@@ -36,6 +40,7 @@ typedef enum {
     STI_ARRAY = 0x0F,
     STI_UINT8 = 0x10,
     STI_PATHSET = 0x12,
+    STI_VECTOR256 = 0x13,
 
     // Custom field types
     STI_CURRENCY = 0xF0,
@@ -45,6 +50,7 @@ typedef enum {
 #define XRP_UINT16_TRANSACTION_TYPE     0x02
 #define XRP_UINT32_FLAGS                0x02
 #define XRP_UINT32_SEQUENCE             0x04
+#define XRP_UINT32_DESTINATION_TAG      0x0E
 #define XRP_UINT32_EXPIRATION           0x0A
 #define XRP_UINT32_TRANSFER_RATE        0x0B
 #define XRP_UINT32_QUALITY_IN           0x14
@@ -101,21 +107,15 @@ typedef struct {
     uint8_t buf[32];
 } hash256_t;
 
+// Compact field record: the value is not copied but referenced by its offset in the
+// transaction data, and scalar values are decoded on demand (see field_u32 etc).
 typedef struct {
-    uint8_t id;
-    field_type_t data_type;
+    uint16_t offset;
     uint16_t length;
-    union {
-        uint8_t u8;
-        uint16_t u16;
-        uint32_t u32;
-        hash128_t *hash128;
-        hash256_t *hash256;
-        xrp_account_t *account;
-        xrp_currency_t *currency;
-        uint8_t *ptr;
-    } data;
+    uint8_t data_type;  // field_type_t
+    uint8_t id;
     array_info_t array_info;
+    uint8_t info;  // Index in the field registry, see field_info.c
 } field_t;
 
 typedef struct {
@@ -126,8 +126,12 @@ typedef struct {
     char buf[MAX_FIELD_LEN];
 } field_value_t;
 
-bool is_normal_account_field(field_t *field);
+uint8_t *field_data(const parseContext_t *context, const field_t *field);
+uint8_t field_u8(const parseContext_t *context, const field_t *field);
+uint16_t field_u16(const parseContext_t *context, const field_t *field);
+uint32_t field_u32(const parseContext_t *context, const field_t *field);
+
 const char *resolve_field_name(field_t *field);
-bool is_field_hidden(field_t *field);
+bool is_field_hidden(parseContext_t *context, field_t *field);
 
 #endif  // LEDGER_APP_XRP_FIELDS_H
@@ -19,22 +19,18 @@
 #include <string.h>
 
 #include "flags.h"
-#include "readers.h"
-#include "sign_transaction.h"
+#include "field_info.h"
+#include "xrp_parse.h"
 #include "transaction_types.h"
 #include "fmt.h"
 
-#define HAS_FLAG(value, flag) ((value) & (flag)) == flag
-
 bool is_flag(const field_t *field) {
-    return field->data_type == STI_UINT32 &&
-           (field->id == XRP_UINT32_FLAGS || field->id == XRP_UINT32_SET_FLAG ||
-            field->id == XRP_UINT32_CLEAR_FLAG);
+    return get_field_info(field)->format == FORMAT_FLAGS;
 }
 
-bool is_flag_hidden(const field_t *field) {
+bool is_flag_hidden(const parseContext_t *context, const field_t *field) {
     if (is_flag(field)) {
-        uint32_t value = field->data.u32;
+        uint32_t value = field_u32(context, field);
 
         return value == 0 || value == TF_FULLY_CANONICAL_SIG;
     }
@@ -42,237 +38,158 @@ bool is_flag_hidden(const field_t *field) {
     return false;
 }
 
-static size_t set_error_value(field_value_t *out) {
-    strncpy(out->buf, "[ERROR: FAILED TO APPEND ITEM]", sizeof(out->buf));
-    return sizeof(out->buf);
+// A bit of the Flags field, or a value of the SetFlag and ClearFlag fields, and its label
+typedef struct {
+    uint32_t value;
+    uint8_t label_length;
+    const char *label;
+} flagLabel_t;
+
+#define FLAG_LABEL(value, label) \
+    { value, sizeof(label) - 1, label }
+
+// How the flags of a transaction type are displayed, indexed by flagSet_t. The bits are
+// listed in display order.
+typedef struct {
+    const flagLabel_t *bits;
+    uint8_t bit_count;
+    const flagLabel_t *field_values;  // SetFlag and ClearFlag, only one value per field
+    uint8_t field_value_count;
+} flagSetInfo_t;
+
+#define FLAG_LABELS(labels) labels, sizeof(labels) / sizeof(labels[0])
+
+static const flagLabel_t account_set_bits[] = {
+    FLAG_LABEL(0x00010000u, "Require Dest Tag"),
+    FLAG_LABEL(0x00020000u, "Optional Dest Tag"),
+    FLAG_LABEL(0x00040000u, "Require Auth"),
+    FLAG_LABEL(0x00080000u, "Optional Auth"),
+    FLAG_LABEL(0x00100000u, "Disallow XRP"),
+    FLAG_LABEL(0x00200000u, "Allow XRP"),
+};
+
+static const flagLabel_t account_set_field_values[] = {
+    FLAG_LABEL(1, "Require Dest"),
+    FLAG_LABEL(2, "Require Auth"),
+    FLAG_LABEL(3, "Disallow XRP"),
+    FLAG_LABEL(4, "Disable Master"),
+    FLAG_LABEL(5, "Track Txn ID"),
+    FLAG_LABEL(6, "No Freeze"),
+    FLAG_LABEL(7, "Global Freeze"),
+    FLAG_LABEL(8, "Ripple by default"),
+    FLAG_LABEL(9, "Deposit Auth"),
+};
+
+static const flagLabel_t offer_create_bits[] = {
+    FLAG_LABEL(0x00010000u, "Passive"),
+    FLAG_LABEL(0x00020000u, "Immediate or Cancel"),
+    FLAG_LABEL(0x00040000u, "Fill or Kill"),
+    FLAG_LABEL(0x00080000u, "Sell"),
+};
+
+static const flagLabel_t payment_bits[] = {
+    FLAG_LABEL(0x00010000u, "No Direct Ripple"),
+    FLAG_LABEL(0x00020000u, "Partial Payment"),
+    FLAG_LABEL(0x00040000u, "Limit Quality"),
+};
+
+static const flagLabel_t trust_set_bits[] = {
+    FLAG_LABEL(0x00010000u, "Setf Auth"),
+    FLAG_LABEL(0x00020000u, "Set No Ripple"),
+    FLAG_LABEL(0x00040000u, "Clear No Ripple"),
+    FLAG_LABEL(0x00100000u, "Set Freeze"),
+    FLAG_LABEL(0x00200000u, "Clear Freeze"),
+};
+
+static const flagLabel_t payment_channel_claim_bits[] = {
+    FLAG_LABEL(0x00010000u, "Renew"),
+    FLAG_LABEL(0x00020000u, "Close"),
+};
+
+static const flagLabel_t nftoken_mint_bits[] = {
+    FLAG_LABEL(0x00000001u, "Burnable"),
+    FLAG_LABEL(0x00000002u, "Only XRP"),
+    FLAG_LABEL(0x00000004u, "Trust Line"),
+    FLAG_LABEL(0x00000008u, "Transferable"),
+};
+
+static const flagLabel_t nftoken_create_offer_bits[] = {
+    FLAG_LABEL(0x00000001u, "Sell NFToken"),
+};
+
+static const flagSetInfo_t flag_sets[] = {
+    [FLAG_SET_NONE] = {NULL, 0, NULL, 0},
+    [FLAG_SET_ACCOUNT_SET] = {FLAG_LABELS(account_set_bits),
+                              FLAG_LABELS(account_set_field_values)},
+    [FLAG_SET_OFFER_CREATE] = {FLAG_LABELS(offer_create_bits), NULL, 0},
+    [FLAG_SET_PAYMENT] = {FLAG_LABELS(payment_bits), NULL, 0},
+    [FLAG_SET_TRUST_SET] = {FLAG_LABELS(trust_set_bits), NULL, 0},
+    [FLAG_SET_PAYMENT_CHANNEL_CLAIM] = {FLAG_LABELS(payment_channel_claim_bits), NULL, 0},
+    [FLAG_SET_NFTOKEN_MINT] = {FLAG_LABELS(nftoken_mint_bits), NULL, 0},
+    [FLAG_SET_NFTOKEN_CREATE_OFFER] = {FLAG_LABELS(nftoken_create_offer_bits), NULL, 0},
+};
+
+static void write_label(textWriter_t *out, const flagLabel_t *flag) {
+    write_chars(out, (const char *) PIC(flag->label), flag->label_length);
 }
 
-static size_t append_item(field_value_t *out, size_t offset, const char *in) {
-    size_t len = strlen(in);
+// Lists the labels of all bits set in value, returns false if there were none
+static bool write_bit_labels(const flagLabel_t *bits,
+                             uint8_t count,
+                             uint32_t value,
+                             textWriter_t *out) {
+    bool found = false;
 
-    if (offset != 0) {
-        if (sizeof(out->buf) - offset < 3) {
-            return set_error_value(out);
+    for (uint8_t i = 0; i < count; i++) {
+        if ((value & bits[i].value) != bits[i].value) {
+            continue;
         }
-        out->buf[offset + 0] = ',';
-        out->buf[offset + 1] = ' ';
-        out->buf[offset + 2] = '\x00';
-        offset += 2;
-    }
-
-    if (len >= sizeof(out->buf) - offset) {
-        return set_error_value(out);
-    }
-
-    strncpy(out->buf + offset, in, sizeof(out->buf) - offset);
-
-    return offset + len;
-}
-
-static void format_account_set_transaction_flags(uint32_t value, field_value_t *dst) {
-// AccountSet flags
-#define TF_REQUIRE_DEST_TAG  0x00010000u
-#define TF_OPTIONAL_DEST_TAG 0x00020000u
-#define TF_REQUIRE_AUTH      0x00040000u
-#define TF_OPTIONAL_AUTH     0x00080000u
-#define TF_DISALLOW_XRP      0x00100000u
-#define TF_ALLOW_XRP         0x00200000u
-
-    size_t offset = 0;
-    if (HAS_FLAG(value, TF_REQUIRE_DEST_TAG)) {
-        offset = append_item(dst, offset, "Require Dest Tag");
-    }
-
-    if (HAS_FLAG(value, TF_OPTIONAL_DEST_TAG)) {
-        offset = append_item(dst, offset, "Optional Dest Tag");
-    }
-
-    if (HAS_FLAG(value, TF_REQUIRE_AUTH)) {
-        offset = append_item(dst, offset, "Require Auth");
-    }
 
-    if (HAS_FLAG(value, TF_OPTIONAL_AUTH)) {
-        offset = append_item(dst, offset, "Optional Auth");
-    }
-
-    if (HAS_FLAG(value, TF_DISALLOW_XRP)) {
-        offset = append_item(dst, offset, "Disallow XRP");
-    }
-
-    if (HAS_FLAG(value, TF_ALLOW_XRP)) {
-        append_item(dst, offset, "Allow XRP");
-    }
-}
-
-static const char *format_account_set_field_flags(uint32_t value) {
-// AccountSet flags for fields SetFlag and ClearFlag
-#define ASF_ACCOUNT_TXN_ID 5
-#define ASF_DEFAULT_RIPPLE 8
-#define ASF_DEPOSIT_AUTH   9
-#define ASF_DISABLE_MASTER 4
-#define ASF_DISALLOW_XRP   3
-#define ASF_GLOBAL_FREEZE  7
-#define ASF_NO_FREEZE      6
-#define ASF_REQUIRE_AUTH   2
-#define ASF_REQUIRE_DEST   1
-
-    // Logic is different because only one flag is allowed per field
-    switch (value) {
-        case ASF_ACCOUNT_TXN_ID:
-            return "Track Txn ID";
-        case ASF_DEFAULT_RIPPLE:
-            return "Ripple by default";
-        case ASF_DEPOSIT_AUTH:
-            return "Deposit Auth";
-        case ASF_DISABLE_MASTER:
-            return "Disable Master";
-        case ASF_DISALLOW_XRP:
-            return "Disallow XRP";
-        case ASF_GLOBAL_FREEZE:
-            return "Global Freeze";
-        case ASF_NO_FREEZE:
-            return "No Freeze";
-        case ASF_REQUIRE_AUTH:
-            return "Require Auth";
-        case ASF_REQUIRE_DEST:
-            return "Require Dest";
-        default:
-            return NULL;
-    }
-}
-
-static void format_account_set_flags(field_t *field, uint32_t value, field_value_t *dst) {
-    if (field->id == XRP_UINT32_FLAGS) {
-        format_account_set_transaction_flags(value, dst);
-    } else {
-        const char *flag = format_account_set_field_flags(value);
-        if (flag != NULL) {
-            strncpy(dst->buf, flag, sizeof(dst->buf));
-        } else {
-            snprintf(dst->buf, sizeof(dst->buf), "Unknown flag: %u", value);
+        if (found) {
+            write_chars(out, ", ", 2);
         }
-    }
-}
-
-static void format_offer_create_flags(uint32_t value, field_value_t *dst) {
-// OfferCreate flags
-#define TF_PASSIVE             0x00010000u
-#define TF_IMMEDIATE_OR_CANCEL 0x00020000u
-#define TF_FILL_OR_KILL        0x00040000u
-#define TF_SELL                0x00080000u
-
-    size_t offset = 0;
-    if (HAS_FLAG(value, TF_PASSIVE)) {
-        offset = append_item(dst, offset, "Passive");
-    }
-
-    if (HAS_FLAG(value, TF_IMMEDIATE_OR_CANCEL)) {
-        offset = append_item(dst, offset, "Immediate or Cancel");
-    }
-
-    if (HAS_FLAG(value, TF_FILL_OR_KILL)) {
-        offset = append_item(dst, offset, "Fill or Kill");
-    }
-
-    if (HAS_FLAG(value, TF_SELL)) {
-        append_item(dst, offset, "Sell");
-    }
-}
-
-static void format_payment_flags(uint32_t value, field_value_t *dst) {
-// Payment flags
-#define TF_NO_RIPPLE_DIRECT 0x00010000u
-#define TF_PARTIAL_PAYMENT  0x00020000u
-#define TF_LIMIT_QUALITY    0x00040000u
-
-    size_t offset = 0;
-    if (HAS_FLAG(value, TF_NO_RIPPLE_DIRECT)) {
-        offset = append_item(dst, offset, "No Direct Ripple");
+        write_label(out, &bits[i]);
+        found = true;
     }
 
-    if (HAS_FLAG(value, TF_PARTIAL_PAYMENT)) {
-        offset = append_item(dst, offset, "Partial Payment");
-    }
-
-    if (HAS_FLAG(value, TF_LIMIT_QUALITY)) {
-        append_item(dst, offset, "Limit Quality");
-    }
+    return found;
 }
 
-static void format_trust_set_flags(uint32_t value, field_value_t *dst) {
-// TrustSet flags
-#define TF_SETF_AUTH       0x00010000u
-#define TF_SET_NO_RIPPLE   0x00020000u
-#define TF_CLEAR_NO_RIPPLE 0x00040000u
-#define TF_SET_FREEZE      0x00100000u
-#define TF_CLEAR_FREEZE    0x00200000u
-
-    size_t offset = 0;
-    if (HAS_FLAG(value, TF_SETF_AUTH)) {
-        offset = append_item(dst, offset, "Setf Auth");
-    }
-
-    if (HAS_FLAG(value, TF_SET_NO_RIPPLE)) {
-        offset = append_item(dst, offset, "Set No Ripple");
-    }
-
-    if (HAS_FLAG(value, TF_CLEAR_NO_RIPPLE)) {
-        offset = append_item(dst, offset, "Clear No Ripple");
-    }
-
-    if (HAS_FLAG(value, TF_SET_FREEZE)) {
-        offset = append_item(dst, offset, "Set Freeze");
+static void write_field_value_label(const flagLabel_t *values,
+                                    uint8_t count,
+                                    uint32_t value,
+                                    textWriter_t *out) {
+    for (uint8_t i = 0; i < count; i++) {
+        if (values[i].value == value) {
+            write_label(out, &values[i]);
+            return;
+        }
     }
 
-    if (HAS_FLAG(value, TF_CLEAR_FREEZE)) {
-        append_item(dst, offset, "Clear Freeze");
-    }
+    write_string(out, "Unknown flag: ");
+    write_uint(out, value);
 }
 
-static void format_payment_channel_claim_flags(uint32_t value, field_value_t *dst) {
-// PaymentChannelClaim flags
-#define TF_RENEW 0x00010000u
-#define TF_CLOSE 0x00020000u
+void format_flags(parseContext_t *context, field_t *field, textWriter_t *out) {
+    uint32_t value = field_u32(context, field);
+    uint8_t flag_set = context->transaction_info->flag_set;
 
-    size_t offset = 0;
-    if (HAS_FLAG(value, TF_RENEW)) {
-        offset = append_item(dst, offset, "Renew");
+    if (flag_set == FLAG_SET_NONE || flag_set >= sizeof(flag_sets) / sizeof(flag_sets[0])) {
+        write_string(out, "No flags for transaction type ");
+        write_uint(out, context->transaction_type);
+        return;
     }
 
-    if (HAS_FLAG(value, TF_CLOSE)) {
-        append_item(dst, offset, "Close");
-    }
-}
-
-void format_flags(field_t *field, field_value_t *dst) {
-    uint32_t value = field->data.u32;
-    switch (parse_context.transaction_type) {
-        case TRANSACTION_ACCOUNT_SET:
-            format_account_set_flags(field, value, dst);
-            break;
-        case TRANSACTION_OFFER_CREATE:
-            format_offer_create_flags(value, dst);
-            break;
-        case TRANSACTION_PAYMENT:
-            format_payment_flags(value, dst);
-            break;
-        case TRANSACTION_TRUST_SET:
-            format_trust_set_flags(value, dst);
-            break;
-        case TRANSACTION_PAYMENT_CHANNEL_CLAIM:
-            format_payment_channel_claim_flags(value, dst);
-            break;
-        default:
-            snprintf(dst->buf,
-                     sizeof(dst->buf),
-                     "No flags for transaction type %d",
-                     parse_context.transaction_type);
-            return;
+    const flagSetInfo_t *info = &flag_sets[flag_set];
+    const flagLabel_t *field_values = (const flagLabel_t *) PIC(info->field_values);
+    if (field->id != XRP_UINT32_FLAGS && field_values != NULL) {
+        write_field_value_label(field_values, info->field_value_count, value, out);
+        return;
     }
 
     // Check if no flags were found (despite is_flag_hidden returning false) and respond
     // appropriately
-    if (dst->buf[0] == 0x00) {
-        strncpy(dst->buf, "Unsupported value", sizeof(dst->buf));
+    if (!write_bit_labels((const flagLabel_t *) PIC(info->bits), info->bit_count, value, out)) {
+        write_string(out, "Unsupported value");
     }
 }
@@ -21,12 +21,25 @@
 
 #include <stdbool.h>
 #include "fields.h"
+#include "text_writer.h"
 
 // Universal Transaction flags (hidden)
 #define TF_FULLY_CANONICAL_SIG 0x80000000u
 
+// Transaction specific flags, see transaction_types.c
+typedef enum {
+    FLAG_SET_NONE = 0,
+    FLAG_SET_ACCOUNT_SET,
+    FLAG_SET_OFFER_CREATE,
+    FLAG_SET_PAYMENT,
+    FLAG_SET_TRUST_SET,
+    FLAG_SET_PAYMENT_CHANNEL_CLAIM,
+    FLAG_SET_NFTOKEN_MINT,
+    FLAG_SET_NFTOKEN_CREATE_OFFER,
+} flagSet_t;
+
 bool is_flag(const field_t* field);
-bool is_flag_hidden(const field_t* field);
-void format_flags(field_t* field, field_value_t* dst);
+bool is_flag_hidden(const parseContext_t* context, const field_t* field);
+void format_flags(parseContext_t* context, field_t* field, textWriter_t* out);
 
 #endif  // LEDGER_APP_XRP_FLAGS_H
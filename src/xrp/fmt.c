@@ -16,56 +16,97 @@
  *  limitations under the License.
  ********************************************************************************/
 
-#include <string.h>
-
 #include "fmt.h"
 #include "amount.h"
 #include "general.h"
 
-void format_field(field_t* field, field_value_t* dst) {
-    memset(dst->buf, '\x00', sizeof(dst->buf));
+// Characters on a page, the last one of a field_value_t is the terminating null byte
+#define PAGE_LENGTH (MAX_FIELD_LEN - 1)
+
+static bool is_blob(field_t* field) {
+    return field->data_type == STI_VL || field->data_type == STI_VECTOR256;
+}
+
+// Bytes of the blob displayed on a full page, two characters per byte in hex
+static uint16_t get_page_bytes(parseContext_t* context, field_t* field) {
+    return is_blob_displayed_as_string(context, field) ? PAGE_LENGTH : PAGE_LENGTH / 2;
+}
+
+static void finish_value(textWriter_t* out) {
+    // Replace a zero-length string with a space because of rendering issues
+    if (out->length == 0) {
+        write_char(out, ' ');
+    }
+}
+
+void format_field(parseContext_t* context, field_t* field, field_value_t* dst) {
+    textWriter_t out;
+    writer_init(&out, dst->buf, sizeof(dst->buf));
 
-    int ret = 0;
     switch (field->data_type) {
         case STI_UINT8:
-            uint8_formatter(field, dst);
+            uint8_formatter(context, field, &out);
             break;
         case STI_UINT16:
-            uint16_formatter(field, dst);
+            uint16_formatter(context, field, &out);
             break;
         case STI_UINT32:
-            uint32_formatter(field, dst);
+            uint32_formatter(context, field, &out);
             break;
         case STI_HASH128:
-            hash_formatter128(field, dst);
+            hash_formatter128(context, field, &out);
             break;
         case STI_HASH256:
-            hash_formatter256(field, dst);
+            hash_formatter256(context, field, &out);
             break;
         case STI_AMOUNT:
-            amount_formatter(field, dst);
+            amount_formatter(context, field, &out);
             break;
         case STI_VL:
-            blob_formatter(field, dst);
+        case STI_VECTOR256:
+            blob_formatter(context, field, &out);
             break;
         case STI_ACCOUNT:
-            account_formatter(field, dst);
+            account_formatter(context, field, &out);
             break;
         case STI_CURRENCY:
-            currency_formatter(field, dst);
+            currency_formatter(context, field, &out);
             break;
         default:
-            strncpy(dst->buf, "[Not implemented]", sizeof(dst->buf));
+            write_string(&out, "[Not implemented]");
             break;
     }
 
-    if (ret != 0) {
-        strncpy(dst->buf, "[ERROR DURING FORMATTING]", sizeof(dst->buf));
+    finish_value(&out);
+}
+
+uint8_t get_field_page_count(parseContext_t* context, field_t* field) {
+    if (!is_blob(field) || field->length == 0) {
+        return 1;
+    }
+
+    uint16_t page_bytes = get_page_bytes(context, field);
+    return (field->length + page_bytes - 1) / page_bytes;
+}
+
+void format_field_page(parseContext_t* context, field_t* field, uint8_t page, field_value_t* dst) {
+    if (!is_blob(field)) {
+        format_field(context, field, dst);
         return;
     }
 
-    // Replace a zero-length string with a space because of rendering issues
-    if (dst->buf[0] == '\x00') {
-        dst->buf[0] = ' ';
+    textWriter_t out;
+    writer_init(&out, dst->buf, sizeof(dst->buf));
+
+    uint16_t page_bytes = get_page_bytes(context, field);
+    uint16_t offset = page * page_bytes;
+    if (offset < field->length) {
+        uint16_t length = field->length - offset;
+        if (length > page_bytes) {
+            length = page_bytes;
+        }
+        blob_window_formatter(context, field, offset, length, &out);
     }
+
+    finish_value(&out);
 }
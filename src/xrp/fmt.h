@@ -2,4 +2,11 @@
 
 #include "fields.h"
 
-void format_field(field_t* field, field_value_t* dst);
+// The whole value, cut with "..." if it is longer than a field_value_t
+void format_field(parseContext_t* context, field_t* field, field_value_t* dst);
+
+// Blobs longer than a field_value_t are displayed on several pages, each of them
+// formatted straight from the transaction data so that the RAM used doesn't depend on
+// the length of the field. Other fields have a single page, the same as format_field.
+uint8_t get_field_page_count(parseContext_t* context, field_t* field);
+void format_field_page(parseContext_t* context, field_t* field, uint8_t page, field_value_t* dst);
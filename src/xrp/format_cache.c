@@ -0,0 +1,116 @@
+/*******************************************************************************
+ *   XRP Wallet
+ *   (c) 2020 Towo Labs
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+#include <string.h>
+
+#include "format_cache.h"
+#include "fmt.h"
+#include "text_writer.h"
+
+static void format_title(field_t *field, uint8_t page, uint8_t page_count, field_name_t *title) {
+    textWriter_t out;
+    writer_init(&out, title->buf, sizeof(title->buf));
+
+    write_string(&out, resolve_field_name(field));
+    if (field->array_info.type == ARRAY_PATHSET) {
+        write_path_step_index(&out, field->array_info.index1, field->array_info.index2);
+    } else if (field->array_info.type != ARRAY_NONE) {
+        write_array_index(&out, field->array_info.index1);
+    }
+
+    if (page_count > 1) {
+        write_page_number(&out, page, page_count);
+    }
+}
+
+void format_cache_reset(formatCache_t *cache) {
+    memset(cache, 0, sizeof(formatCache_t));
+}
+
+const formattedField_t *get_formatted_field(formatCache_t *cache,
+                                            parseContext_t *transaction,
+                                            uint8_t index,
+                                            uint8_t page) {
+    for (uint8_t i = 0; i < cache->count; ++i) {
+        if (cache->entries[i].index == index && cache->entries[i].page == page) {
+            cache->entries[i].last_use = ++cache->clock;
+            cache->hits++;
+            return &cache->entries[i];
+        }
+    }
+
+    formattedField_t *entry = &cache->entries[0];
+    if (cache->count < FORMAT_CACHE_SIZE) {
+        entry = &cache->entries[cache->count++];
+    } else {
+        // Unsigned differences stay correct when the clock wraps around
+        for (uint8_t i = 1; i < FORMAT_CACHE_SIZE; ++i) {
+            if ((uint16_t) (cache->clock - cache->entries[i].last_use) >
+                (uint16_t) (cache->clock - entry->last_use)) {
+                entry = &cache->entries[i];
+            }
+        }
+    }
+    entry->last_use = ++cache->clock;
+    cache->misses++;
+
+    field_t *field = get_field(transaction, index);
+    entry->index = index;
+    entry->page = page;
+    if (page == WHOLE_FIELD) {
+        entry->page_count = 1;
+        format_field(transaction, field, &entry->value);
+    } else {
+        entry->page_count = get_field_page_count(transaction, field);
+        format_field_page(transaction, field, page, &entry->value);
+    }
+    format_title(field, page, entry->page_count, &entry->name);
+
+    return entry;
+}
+
+uint16_t get_display_item_count(parseContext_t *transaction) {
+    uint16_t count = 0;
+    uint8_t field_count = get_field_count(transaction);
+
+    for (uint8_t i = 0; i < field_count; ++i) {
+        count += get_field_page_count(transaction, get_field(transaction, i));
+    }
+
+    return count;
+}
+
+void get_display_item(parseContext_t *transaction,
+                      uint16_t item,
+                      uint8_t *index,
+                      uint8_t *page) {
+    uint8_t field_count = get_field_count(transaction);
+
+    // An item past the last one is the first page of the first field
+    *index = 0;
+    *page = 0;
+
+    for (uint8_t i = 0; i < field_count; ++i) {
+        uint8_t page_count = get_field_page_count(transaction, get_field(transaction, i));
+        if (item < page_count) {
+            *index = i;
+            *page = item;
+            return;
+        }
+        item -= page_count;
+    }
+}
@@ -0,0 +1,67 @@
+/*******************************************************************************
+ *   XRP Wallet
+ *   (c) 2020 Towo Labs
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+#ifndef LEDGER_APP_XRP_FORMATCACHE_H
+#define LEDGER_APP_XRP_FORMATCACHE_H
+
+#include "xrp_parse.h"
+
+// Page of a field that stands for its whole value, cut with "..." if it is too long
+#define WHOLE_FIELD 0xff
+
+// Formatted title and value of a page of a field, by display index and page
+typedef struct {
+    uint8_t index;
+    uint8_t page;
+    uint8_t page_count;  // Pages of the field, 1 for WHOLE_FIELD
+    uint16_t last_use;   // Value of the cache clock when the entry was last asked for
+    field_name_t name;   // With the array index and the page, such as "Memo Data [1] (2/3)"
+    field_value_t value;
+} formattedField_t;
+
+// Recently displayed fields, so that scrolling back and forth between review steps
+// or NBGL asking several times for the same pair doesn't format the field again.
+// The least recently used entry is replaced on a miss, so the entries of the last
+// FORMAT_CACHE_SIZE pages asked for stay valid and the UI can display them in place.
+// An all zero cache is empty, so it is invalidated along with approval_strings by
+// reset_transaction_context.
+typedef struct {
+    formattedField_t entries[FORMAT_CACHE_SIZE];
+    uint8_t count;   // Number of valid entries
+    uint16_t clock;  // Incremented on every lookup
+    uint16_t hits;
+    uint16_t misses;
+} formatCache_t;
+
+void format_cache_reset(formatCache_t *cache);
+
+// Format a page of the field with the given display index, unless it is cached. The
+// entry stays valid until FORMAT_CACHE_SIZE other pages have been asked for.
+const formattedField_t *get_formatted_field(formatCache_t *cache,
+                                            parseContext_t *transaction,
+                                            uint8_t index,
+                                            uint8_t page);
+
+// Display items are the pages of all fields, in order. NBGL addresses them by index,
+// while the BAGL flow steps from one page to the next.
+uint16_t get_display_item_count(parseContext_t *transaction);
+void get_display_item(parseContext_t *transaction,
+                      uint16_t item,
+                      uint8_t *index,
+                      uint8_t *page);
+
+#endif  // LEDGER_APP_XRP_FORMATCACHE_H
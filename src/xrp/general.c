@@ -19,148 +19,94 @@
 #include <string.h>
 
 #include "general.h"
-#include "readers.h"
+#include "field_info.h"
 #include "fmt.h"
 #include "flags.h"
-#include "xrp_helpers.h"
+#include "address_cache.h"
+#include "xrp_parse.h"
 #include "time.h"
 #include "ascii_strings.h"
 #include "limitations.h"
 #include "transaction_types.h"
 #include "percentage.h"
+#include "text_writer.h"
 
-#define PAGE_W          16
-#define ADDR_DST_OFFSET (PAGE_W * 3 + 2)
+#define PAGE_W 16
 
-void uint8_formatter(field_t* field, field_value_t* dst) {
-    snprintf(dst->buf, sizeof(dst->buf), "%u", field->data.u8);
+void uint8_formatter(parseContext_t* context, field_t* field, textWriter_t* out) {
+    write_uint(out, field_u8(context, field));
 }
 
-static const char* resolve_transaction_name(uint16_t value) {
-    switch (value) {
-        case TRANSACTION_PAYMENT:
-            return "Payment";
-        case TRANSACTION_ESCROW_CREATE:
-            return "Create Escrow";
-        case TRANSACTION_ESCROW_FINISH:
-            return "Finish Escrow";
-        case TRANSACTION_ACCOUNT_SET:
-            return "Account Setting";
-        case TRANSACTION_ESCROW_CANCEL:
-            return "Cancel Escrow";
-        case TRANSACTION_SET_REGULAR_KEY:
-            return "Set Regular Key";
-        case TRANSACTION_OFFER_CREATE:
-            return "Create Offer";
-        case TRANSACTION_OFFER_CANCEL:
-            return "Cancel Offer";
-        case TRANSACTION_SIGNER_LIST_SET:
-            return "Set Signer List";
-        case TRANSACTION_PAYMENT_CHANNEL_CREATE:
-            return "Create Channel";
-        case TRANSACTION_PAYMENT_CHANNEL_FUND:
-            return "Fund Channel";
-        case TRANSACTION_PAYMENT_CHANNEL_CLAIM:
-            return "Channel Claim";
-        case TRANSACTION_CHECK_CREATE:
-            return "Create Check";
-        case TRANSACTION_CHECK_CASH:
-            return "Cash Check";
-        case TRANSACTION_CHECK_CANCEL:
-            return "Cancel Check";
-        case TRANSACTION_DEPOSIT_PREAUTH:
-            return "Preauth. Deposit";
-        case TRANSACTION_TRUST_SET:
-            return "Set Trust Line";
-        case TRANSACTION_ACCOUNT_DELETE:
-            return "Delete Account";
-        default:
-            return "Unknown";
-    }
-}
-
-void uint16_formatter(field_t* field, field_value_t* dst) {
-    uint16_t value = field->data.u16;
+void uint16_formatter(parseContext_t* context, field_t* field, textWriter_t* out) {
+    uint16_t value = field_u16(context, field);
 
-    if (is_transaction_type_field(field)) {
-        const char* name = resolve_transaction_name(value);
-        strncpy(dst->buf, name, sizeof(dst->buf));
+    if (get_field_info(field)->format == FORMAT_TRANSACTION_TYPE) {
+        write_string(out, (const char*) PIC(get_transaction_info(value)->name));
     } else {
-        snprintf(dst->buf, sizeof(dst->buf), "%u", value);
+        write_uint(out, value);
     }
 }
 
-void uint32_formatter(field_t* field, field_value_t* dst) {
+void uint32_formatter(parseContext_t* context, field_t* field, textWriter_t* out) {
     if (is_flag(field)) {
-        format_flags(field, dst);
+        format_flags(context, field, out);
     } else if (is_time(field)) {
-        format_time(field, dst);
+        format_time(context, field, out);
     } else if (is_time_delta(field)) {
-        format_time_delta(field, dst);
+        format_time_delta(context, field, out);
     } else if (is_percentage(field)) {
-        format_percentage(field, dst);
+        format_percentage(context, field, out);
     } else {
-        uint32_t value = field->data.u32;
-        snprintf(dst->buf, sizeof(dst->buf), "%u", value);
+        write_uint(out, field_u32(context, field));
     }
 }
 
-void hash_formatter128(field_t* field, field_value_t* dst) {
-    read_hex(dst->buf,
-             sizeof(dst->buf),
-             field->data.hash128->buf,
-             sizeof(field->data.hash128->buf));
+void hash_formatter128(parseContext_t* context, field_t* field, textWriter_t* out) {
+    write_hex(out, field_data(context, field), sizeof(hash128_t));
 }
 
-void hash_formatter256(field_t* field, field_value_t* dst) {
-    read_hex(dst->buf,
-             sizeof(dst->buf),
-             field->data.hash256->buf,
-             sizeof(field->data.hash256->buf));
+void hash_formatter256(parseContext_t* context, field_t* field, textWriter_t* out) {
+    write_hex(out, field_data(context, field), sizeof(hash256_t));
 }
 
-static bool should_format_blob_as_string(field_t* field) {
-    switch (field->id) {
-        case XRP_VL_DOMAIN:
-        case XRP_VL_MEMO_TYPE:
-        case XRP_VL_MEMO_FORMAT:
+bool is_blob_displayed_as_string(parseContext_t* context, field_t* field) {
+    switch (get_field_info(field)->format) {
+        case FORMAT_STRING:
             return true;
-        case XRP_VL_MEMO_DATA:
-            return is_purely_ascii(field->data.ptr, field->length, false);
+        case FORMAT_ASCII_OR_HEX:
+            return is_purely_ascii(field_data(context, field), field->length, false);
         default:
             return false;
     }
 }
 
-void blob_formatter(field_t* field, field_value_t* dst) {
-    bool too_long = false;
-    size_t max_size = sizeof(dst->buf) - 1;
+void blob_window_formatter(parseContext_t* context,
+                           field_t* field,
+                           uint16_t offset,
+                           uint16_t length,
+                           textWriter_t* out) {
+    const uint8_t* data = field_data(context, field) + offset;
 
-    if (should_format_blob_as_string(field)) {
-        memcpy(dst->buf, field->data.ptr, MIN(max_size, field->length));
-        if (field->length > max_size) {
-            too_long = true;
-        }
+    if (is_blob_displayed_as_string(context, field)) {
+        write_chars(out, (const char*) data, length);
     } else {
-        too_long = !read_hex(dst->buf, max_size, field->data.ptr, field->length);
+        write_hex(out, data, length);
     }
-    dst->buf[max_size] = '\x00';
+}
 
-    if (too_long) {
-        strncpy(dst->buf + sizeof(dst->buf) - 4, "...", 4);
-    }
+void blob_formatter(parseContext_t* context, field_t* field, textWriter_t* out) {
+    blob_window_formatter(context, field, 0, field->length, out);
 }
 
-void account_formatter(field_t* field, field_value_t* dst) {
-    if (field->data.ptr == NULL) {
-        strncpy(dst->buf, "[empty]", sizeof(dst->buf));
+void account_formatter(parseContext_t* context, field_t* field, textWriter_t* out) {
+    if (field->length == 0) {
+        write_string(out, "[empty]");
         return;
     }
 
-    // Write full address to dst + ADDR_DST_OFFSET
-    xrp_account_t* account = field->data.account;
-    xrp_address_t* address = (xrp_address_t*) (dst->buf + ADDR_DST_OFFSET);
-    uint16_t addr_length = xrp_public_key_to_encoded_base58(NULL, account, address, 0);
+    xrp_account_t* account = (xrp_account_t*) field_data(context, field);
+    const cachedAddress_t* entry = get_encoded_address(&context->addresses, account);
+    uint16_t addr_length = entry->length;
 
     if (DISPLAY_SEGMENTED_ADDR && addr_length <= PAGE_W * 3) {
         // If the application is configured to split addresses on the target
@@ -178,21 +124,19 @@ void account_formatter(field_t* field, field_value_t* dst) {
         uint16_t base_padding = (PAGE_W - base_segment_len) / 2;
         uint16_t long_padding = (PAGE_W - long_segment_len) / 2;
 
-        // 3. Fill all three pages with spaces and copy the every segment
-        //    to their corresponding position
-        uint8_t* p = (uint8_t*) address;
-        memset(dst->buf, ' ', PAGE_W * 3);
-        memmove(dst->buf + PAGE_W * 0 + long_padding, p, long_segment_len);
+        // 3. Write every segment surrounded by spaces on its own page
+        const char* p = entry->address;
+        write_repeat(out, ' ', long_padding);
+        write_chars(out, p, long_segment_len);
+        write_repeat(out, ' ', PAGE_W - long_padding - long_segment_len + base_padding);
         p += long_segment_len;
-        memmove(dst->buf + PAGE_W * 1 + base_padding, p, base_segment_len);
+        write_chars(out, p, base_segment_len);
+        write_repeat(out, ' ', PAGE_W - base_segment_len);
         p += base_segment_len;
-        memmove(dst->buf + PAGE_W * 2 + base_padding, p, base_segment_len);
-
-        dst->buf[48] = '\x00';
+        write_chars(out, p, base_segment_len);
+        write_repeat(out, ' ', PAGE_W - base_padding - base_segment_len);
     } else {
-        // Application is configured with normal address formatting, make sure
-        // that the address is moved to the beginning of our dst
-        memmove(dst->buf, address, addr_length);
-        dst->buf[addr_length] = '\x00';
+        // Application is configured with normal address formatting
+        write_chars(out, entry->address, addr_length);
     }
 }
@@ -20,13 +20,24 @@
 #define LEDGER_APP_XRP_GENERAL_H
 
 #include "fields.h"
+#include "text_writer.h"
 
-void uint8_formatter(field_t* field, field_value_t* dst);
-void uint16_formatter(field_t* field, field_value_t* dst);
-void uint32_formatter(field_t* field, field_value_t* dst);
-void hash_formatter128(field_t* field, field_value_t* dst);
-void hash_formatter256(field_t* field, field_value_t* dst);
-void blob_formatter(field_t* field, field_value_t* dst);
-void account_formatter(field_t* field, field_value_t* dst);
+void uint8_formatter(parseContext_t* context, field_t* field, textWriter_t* out);
+void uint16_formatter(parseContext_t* context, field_t* field, textWriter_t* out);
+void uint32_formatter(parseContext_t* context, field_t* field, textWriter_t* out);
+void hash_formatter128(parseContext_t* context, field_t* field, textWriter_t* out);
+void hash_formatter256(parseContext_t* context, field_t* field, textWriter_t* out);
+void blob_formatter(parseContext_t* context, field_t* field, textWriter_t* out);
+void account_formatter(parseContext_t* context, field_t* field, textWriter_t* out);
+
+// Blobs are displayed as text or as hex, the choice is made for the whole field
+bool is_blob_displayed_as_string(parseContext_t* context, field_t* field);
+
+// Part of a blob, length bytes from offset, formatted straight from the transaction data
+void blob_window_formatter(parseContext_t* context,
+                           field_t* field,
+                           uint16_t offset,
+                           uint16_t length,
+                           textWriter_t* out);
 
 #endif  // LEDGER_APP_XRP_GENERAL_H
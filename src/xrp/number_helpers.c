@@ -15,6 +15,9 @@
  *  limitations under the License.
  ********************************************************************************/
 
+#include <stdbool.h>
+#include <string.h>
+
 #include "number_helpers.h"
 
 char int_to_number_char(uint64_t value) {
@@ -24,3 +27,84 @@ char int_to_number_char(uint64_t value) {
 
     return (char) ('0' + value);
 }
+
+// Divide the big endian number in place by 10000 and return the remainder. Every step
+// divides less than 10000 * 256 by 10000, 1677 / 2^24 is slightly below 1 / 10000 so the
+// estimated quotient is exact or one too small.
+static uint32_t divide_by_10000(uint8_t *bytes, uint8_t length) {
+    uint32_t remainder = 0;
+
+    for (uint8_t i = 0; i < length; i++) {
+        uint32_t value = remainder * 256 + bytes[i];
+        uint32_t quotient = (value * 1677) >> 24;
+        remainder = value - quotient * 10000;
+        if (remainder >= 10000) {
+            quotient++;
+            remainder -= 10000;
+        }
+        bytes[i] = quotient;
+    }
+
+    return remainder;
+}
+
+static void write_4_digits(uint32_t value, char *out) {
+    uint32_t high = (value * 5243) >> 19;  // value / 100, exact below 43699
+    uint32_t low = value - high * 100;
+    uint32_t high_tens = (high * 103) >> 10;  // high / 10, exact below 179
+    uint32_t low_tens = (low * 103) >> 10;
+
+    out[0] = '0' + high_tens;
+    out[1] = '0' + (high - high_tens * 10);
+    out[2] = '0' + low_tens;
+    out[3] = '0' + (low - low_tens * 10);
+}
+
+uint8_t decimal_digits(uint64_t value, char *out) {
+    uint32_t high = value >> 32;
+    uint32_t low = (uint32_t) value;
+    uint8_t bytes[8];
+    char digits[MAX_DECIMAL_DIGITS];
+    uint8_t start = 0;
+    uint8_t position = sizeof(digits);
+
+    for (uint8_t i = 0; i < 4; i++) {
+        bytes[i] = high >> (24 - 8 * i);
+        bytes[i + 4] = low >> (24 - 8 * i);
+    }
+
+    // Groups of four digits, least significant first
+    while (true) {
+        while (start < sizeof(bytes) && bytes[start] == 0) {
+            start++;
+        }
+        if (start == sizeof(bytes)) {
+            break;
+        }
+
+        position -= 4;
+        write_4_digits(divide_by_10000(bytes + start, sizeof(bytes) - start), digits + position);
+    }
+
+    while (position < sizeof(digits) && digits[position] == '0') {
+        position++;
+    }
+
+    uint8_t length = sizeof(digits) - position;
+    memcpy(out, digits + position, length);
+
+    return length;
+}
+
+uint8_t decimal_digits_normalized(uint64_t mantissa, int16_t *exponent, char *out) {
+    char digits[MAX_DECIMAL_DIGITS];
+    uint8_t length = decimal_digits(mantissa, digits);
+
+    while (length > 0 && digits[length - 1] == '0') {
+        length--;
+        (*exponent)++;
+    }
+    memcpy(out, digits, length);
+
+    return length;
+}
@@ -19,4 +19,17 @@
 
 #include <stdint.h>
 
+// Number of decimal digits of UINT64_MAX
+#define MAX_DECIMAL_DIGITS 20
+
 char int_to_number_char(uint64_t value);
+
+// Write the decimal digits of value, most significant first and without a terminating NUL,
+// to out (MAX_DECIMAL_DIGITS characters). Zero has no digits. The digits are extracted
+// with 32-bit multiplications only, Cortex-M0 has no hardware division and 64-bit
+// divisions are slow runtime calls.
+uint8_t decimal_digits(uint64_t value, char *out);
+
+// Write the digits of mantissa like decimal_digits, without its trailing zeros, which are
+// added to the exponent instead.
+uint8_t decimal_digits_normalized(uint64_t mantissa, int16_t *exponent, char *out);
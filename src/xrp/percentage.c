@@ -15,10 +15,10 @@
  *  limitations under the License.
  ********************************************************************************/
 
-#include <stdio.h>
 #include <string.h>
 
 #include "percentage.h"
+#include "field_info.h"
 #include "readers.h"
 #include "fmt.h"
 #include "limitations.h"
@@ -26,76 +26,53 @@
 #define DENOMINATOR 10000000
 
 bool is_percentage(field_t *field) {
-    if (field->data_type == STI_UINT32) {
-        switch (field->id) {
-            case XRP_UINT32_TRANSFER_RATE:
-            case XRP_UINT32_QUALITY_IN:
-            case XRP_UINT32_QUALITY_OUT:
-                return true;
-            default:
-                return false;
-        }
-    } else {
-        return false;
-    }
+    return get_field_info(field)->format == FORMAT_PERCENTAGE;
 }
 
-void remove_redundant_decimals(field_value_t *dst) {
-    size_t end = strlen(dst->buf);
-    while (end > 0) {
-        char c = dst->buf[end];
-        if (c == '0' || c == '\0') {
-            // Redundant character, remove and continue searching
-            end--;
-            continue;
-        } else if (c == '.') {
-            // We have reached the end of the decimals, break at next char
-            end--;
-            break;
-        } else {
-            // We have reached a non-zero decimal, break at current char
-            break;
-        }
-    }
+static void format_percentage_internal(textWriter_t *out, uint32_t value) {
+    uint32_t integer_part = value / DENOMINATOR;
+    uint32_t decimal_part = value - integer_part * DENOMINATOR;
 
-    dst->buf[end + 1] = '\0';
-}
-
-static void format_percentage_internal(field_value_t *dst, uint32_t value) {
-    unsigned int decimal_part = value % DENOMINATOR;
-    unsigned int integer_part = (value - decimal_part) / DENOMINATOR;
+    write_uint(out, integer_part);
+    if (decimal_part != 0) {
+        // Seven decimals without the redundant trailing zeros
+        uint8_t decimals = 7;
+        while (decimal_part % 10 == 0) {
+            decimal_part /= 10;
+            decimals--;
+        }
 
-    snprintf(dst->buf, sizeof(dst->buf), "%u.%07u", integer_part, decimal_part);
-    remove_redundant_decimals(dst);
+        write_char(out, '.');
+        write_uint_padded(out, decimal_part, decimals);
+    }
 
-    size_t total_length = strlen(dst->buf);
-    strncpy(dst->buf + total_length, " %", sizeof(dst->buf) - total_length);
+    write_string(out, " %");
 }
 
-static void format_transfer_rate(field_value_t *dst, uint32_t value) {
+static void format_transfer_rate(textWriter_t *out, uint32_t value) {
     if (value == 0) {
-        strncpy(dst->buf, "0 %", sizeof(dst->buf));
+        write_string(out, "0 %");
     } else if (value < 1000000000) {
-        strncpy(dst->buf, "Invalid value", sizeof(dst->buf));
+        write_string(out, "Invalid value");
     } else {
-        format_percentage_internal(dst, value - 1000000000);
+        format_percentage_internal(out, value - 1000000000);
     }
 }
 
-static void format_quality(field_value_t *dst, uint32_t value) {
+static void format_quality(textWriter_t *out, uint32_t value) {
     if (value == 0) {
-        strncpy(dst->buf, "100 %", sizeof(dst->buf));
+        write_string(out, "100 %");
     } else {
-        format_percentage_internal(dst, value);
+        format_percentage_internal(out, value);
     }
 }
 
-void format_percentage(field_t *field, field_value_t *dst) {
-    uint32_t value = field->data.u32;
+void format_percentage(parseContext_t *context, field_t *field, textWriter_t *out) {
+    uint32_t value = field_u32(context, field);
 
     if (field->id == XRP_UINT32_TRANSFER_RATE) {
-        format_transfer_rate(dst, value);
+        format_transfer_rate(out, value);
     } else {
-        format_quality(dst, value);
+        format_quality(out, value);
     }
 }
@@ -20,8 +20,9 @@
 
 #include <stdbool.h>
 #include "fields.h"
+#include "text_writer.h"
 
 bool is_percentage(field_t* field);
-void format_percentage(field_t* field, field_value_t* dst);
+void format_percentage(parseContext_t* context, field_t* field, textWriter_t* out);
 
 #endif  // LEDGER_APP_XRP_PERCENTAGE_H
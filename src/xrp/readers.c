@@ -20,27 +20,15 @@
 
 #include "readers.h"
 
-uint64_t read_unsigned64(const uint8_t *src) {
-    uint64_t value = 0;
-    const size_t num_bytes = 8;
-    for (uint8_t i = 0; i < num_bytes; ++i) {
-        value |= (uint64_t) src[i] << (num_bytes * 8u - i * 8u - 8u);
-    }
-
-    return value;
+uint16_t read_unsigned16(const uint8_t *src) {
+    return (uint16_t) ((src[0] << 8u) | src[1]);
 }
 
-static char hex(uint8_t n) {
-    return n >= 10 ? 'a' + (n - 10) : '0' + n;
+uint32_t read_unsigned32(const uint8_t *src) {
+    return ((uint32_t) src[0] << 24u) | ((uint32_t) src[1] << 16u) | ((uint32_t) src[2] << 8u) |
+           src[3];
 }
 
-bool read_hex(char *dst, size_t dst_size, uint8_t *src, size_t src_size) {
-    size_t i;
-
-    for (i = 0; i < src_size && i * 2 + 1 < dst_size; i++) {
-        dst[i * 2 + 0] = hex(src[i] >> 4);
-        dst[i * 2 + 1] = hex(src[i] & 0xf);
-    }
-
-    return i == src_size;
+uint64_t read_unsigned64(const uint8_t *src) {
+    return ((uint64_t) read_unsigned32(src) << 32u) | read_unsigned32(src + 4);
 }
@@ -23,6 +23,6 @@
 
 #include "fields.h"
 
-bool read_hex(char *dst, size_t dst_size, uint8_t *src, size_t src_size);
-
+uint16_t read_unsigned16(const uint8_t *src);
+uint32_t read_unsigned32(const uint8_t *src);
 uint64_t read_unsigned64(const uint8_t *src);
@@ -0,0 +1,176 @@
+/*******************************************************************************
+ *   XRP Wallet
+ *   (c) 2020 Towo Labs
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+#include <string.h>
+
+#include "text_writer.h"
+#include "number_helpers.h"
+
+#define ELLIPSIS "..."
+
+void writer_init(textWriter_t *out, char *buf, size_t capacity) {
+    out->buf = buf;
+    out->capacity = capacity;
+    writer_reset(out);
+}
+
+void writer_reset(textWriter_t *out) {
+    out->length = 0;
+    out->overflow = false;
+    if (out->capacity > 0) {
+        out->buf[0] = '\0';
+    }
+}
+
+static void set_overflow(textWriter_t *out) {
+    size_t ellipsis_length = sizeof(ELLIPSIS) - 1;
+
+    out->overflow = true;
+    if (out->length >= ellipsis_length) {
+        memcpy(out->buf + out->length - ellipsis_length, ELLIPSIS, ellipsis_length);
+    }
+}
+
+void write_chars(textWriter_t *out, const char *chars, size_t length) {
+    if (out->overflow || out->capacity == 0) {
+        return;
+    }
+
+    size_t available = out->capacity - 1 - out->length;
+    bool fits = length <= available;
+    if (!fits) {
+        length = available;
+    }
+
+    memcpy(out->buf + out->length, chars, length);
+    out->length += length;
+    out->buf[out->length] = '\0';
+
+    if (!fits) {
+        set_overflow(out);
+    }
+}
+
+void write_string(textWriter_t *out, const char *str) {
+    write_chars(out, str, strlen(str));
+}
+
+void write_char(textWriter_t *out, char c) {
+    write_chars(out, &c, 1);
+}
+
+void write_repeat(textWriter_t *out, char c, size_t count) {
+    if (out->overflow || out->capacity == 0) {
+        return;
+    }
+
+    size_t available = out->capacity - 1 - out->length;
+    bool fits = count <= available;
+    if (!fits) {
+        count = available;
+    }
+
+    memset(out->buf + out->length, c, count);
+    out->length += count;
+    out->buf[out->length] = '\0';
+
+    if (!fits) {
+        set_overflow(out);
+    }
+}
+
+static const char hex_digits[16] = "0123456789abcdef";
+
+static inline void write_hex_byte(char *dst, uint8_t byte) {
+    dst[0] = hex_digits[byte >> 4];
+    dst[1] = hex_digits[byte & 0xf];
+}
+
+void write_hex(textWriter_t *out, const uint8_t *data, size_t length) {
+    if (out->overflow || out->capacity == 0 || length == 0) {
+        return;
+    }
+
+    size_t available = out->capacity - 1 - out->length;
+    bool fits = length <= available / 2;
+    size_t count = fits ? length : available / 2;
+    char *dst = out->buf + out->length;
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4, dst += 8) {
+        write_hex_byte(dst, data[i]);
+        write_hex_byte(dst + 2, data[i + 1]);
+        write_hex_byte(dst + 4, data[i + 2]);
+        write_hex_byte(dst + 6, data[i + 3]);
+    }
+    for (; i < count; i++, dst += 2) {
+        write_hex_byte(dst, data[i]);
+    }
+
+    // A byte that only half fits is cut after its high nibble
+    if (!fits && available % 2 != 0) {
+        *dst++ = hex_digits[data[count] >> 4];
+    }
+
+    out->length = dst - out->buf;
+    *dst = '\0';
+
+    if (!fits) {
+        set_overflow(out);
+    }
+}
+
+void write_uint_padded(textWriter_t *out, uint32_t value, uint8_t width) {
+    char digits[MAX_DECIMAL_DIGITS];
+
+    // Zero has no digits, it is padded to "0" like snprintf does
+    if (width == 0) {
+        width = 1;
+    }
+
+    uint8_t length = decimal_digits(value, digits);
+    if (width > length) {
+        write_repeat(out, '0', width - length);
+    }
+    write_chars(out, digits, length);
+}
+
+void write_uint(textWriter_t *out, uint32_t value) {
+    write_uint_padded(out, value, 0);
+}
+
+void write_array_index(textWriter_t *out, uint8_t index) {
+    write_string(out, " [");
+    write_uint(out, index);
+    write_char(out, ']');
+}
+
+void write_path_step_index(textWriter_t *out, uint8_t path, uint8_t step) {
+    write_string(out, " [P");
+    write_uint(out, path);
+    write_string(out, ": S");
+    write_uint(out, step);
+    write_char(out, ']');
+}
+
+void write_page_number(textWriter_t *out, uint8_t page, uint8_t count) {
+    write_string(out, " (");
+    write_uint(out, page + 1);
+    write_char(out, '/');
+    write_uint(out, count);
+    write_char(out, ')');
+}
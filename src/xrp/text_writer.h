@@ -0,0 +1,64 @@
+/*******************************************************************************
+ *   XRP Wallet
+ *   (c) 2020 Towo Labs
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Bounded writer used by the field formatters instead of snprintf, strncpy and strlen. The
+// text is kept NUL terminated, so the cost of formatting is proportional to the length of
+// the text and not to the size of the buffer.
+//
+// Truncation rule: a write that doesn't fit is cut, the text ends with "..." and every
+// following write is ignored.
+typedef struct {
+    char *buf;
+    size_t capacity;  // Including the terminating NUL
+    size_t length;
+    bool overflow;
+} textWriter_t;
+
+void writer_init(textWriter_t *out, char *buf, size_t capacity);
+
+// Discard the text written so far, to write an error message instead for instance
+void writer_reset(textWriter_t *out);
+
+void write_chars(textWriter_t *out, const char *chars, size_t length);
+void write_string(textWriter_t *out, const char *str);
+void write_char(textWriter_t *out, char c);
+void write_repeat(textWriter_t *out, char c, size_t count);
+
+// Lowercase hexadecimal, two characters per byte
+void write_hex(textWriter_t *out, const uint8_t *data, size_t length);
+
+// Unsigned decimal, like "%u"
+void write_uint(textWriter_t *out, uint32_t value);
+
+// Unsigned decimal padded with zeros to at least width digits, like "%0*u"
+void write_uint_padded(textWriter_t *out, uint32_t value, uint8_t width);
+
+// Index of an array item in a field title, " [index]"
+void write_array_index(textWriter_t *out, uint8_t index);
+
+// Index of a path step in a field title, " [Ppath: Sstep]"
+void write_path_step_index(textWriter_t *out, uint8_t path, uint8_t step);
+
+// Page of a value displayed on several pages in a field title, " (page/count)" counting
+// from one
+void write_page_number(textWriter_t *out, uint8_t page, uint8_t count);
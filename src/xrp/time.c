@@ -15,133 +15,126 @@
  *  limitations under the License.
  ********************************************************************************/
 
-#include <limits.h>
+#include <string.h>
 
 #include "os.h"
 
 #include "time.h"
+#include "field_info.h"
 #include "readers.h"
 #include "fmt.h"
 #include "limitations.h"
 
-/* 2000-03-01 (mod 400 year, immediately after feb29 */
-#define LEAPOCH             (946684800LL + 86400 * (31 + 29))
-#define RIPPLE_EPOCH_OFFSET 946684800LL
-#define FINAL_EPOCH_OFFSET  (RIPPLE_EPOCH_OFFSET - LEAPOCH)
+#define SECONDS_PER_DAY 86400
+#define DAYS_PER_400Y   (365 * 400 + 97)
 
-#define DAYS_PER_400Y (365 * 400 + 97)
-#define DAYS_PER_100Y (365 * 100 + 24)
-#define DAYS_PER_4Y   (365 * 4 + 1)
+// Days from 1600-03-01, the start of a 400 year cycle that begins right after a leap day,
+// to 2000-01-01, the Ripple epoch
+#define RIPPLE_EPOCH_DAYS (DAYS_PER_400Y - 31 - 29)
+
+// First day of each month in a year that starts in March, so that the leap day is last
+static const uint16_t month_start_days[] = {0, 31, 61, 92, 122, 153, 184, 214, 245, 275, 306, 337};
 
 typedef struct {
-    int tm_sec;  /* seconds after the minute [0-60] */
-    int tm_min;  /* minutes after the hour [0-59] */
-    int tm_hour; /* hours since midnight [0-23] */
-    int tm_mday; /* day of the month [1-31] */
-    int tm_mon;  /* months since January [0-11] */
-    int tm_year; /* years since 1900 */
-} tm_mini_t;
+    uint16_t year;
+    uint8_t month;  // [1-12]
+    uint8_t day;    // [1-31]
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t second;
+} dateTime_t;
 
 bool is_time(field_t *field) {
-    if (field->data_type == STI_UINT32) {
-        switch (field->id) {
-            case XRP_UINT32_EXPIRATION:
-            case XRP_UINT32_CANCEL_AFTER:
-            case XRP_UINT32_FINISH_AFTER:
-                return true;
-            default:
-                return false;
-        }
-    } else {
-        return false;
-    }
+    return get_field_info(field)->format == FORMAT_TIME;
 }
 
 bool is_time_delta(field_t *field) {
-    return field->data_type == STI_UINT32 && field->id == XRP_UINT32_SETTLE_DELAY;
+    return get_field_info(field)->format == FORMAT_TIME_DELTA;
 }
 
-// Inspired from http://git.musl-libc.org/cgit/musl/tree/src/time/__secs_to_tm.c?h=v0.9.15
-static int ripple_epoch_to_tm(long long t, tm_mini_t *tm) {
-    long long days, secs;
-    int remdays, remsecs, remyears;
-    int qc_cycles, c_cycles, q_cycles;
-    int years, months;
-    static const char days_in_month[] = {31, 30, 31, 30, 31, 31, 30, 31, 30, 31, 31, 29};
-
-    /* Reject time_t values whose year would overflow int */
-    if (t < INT_MIN * 31622400LL || t > INT_MAX * 31622400LL) return -1;
-
-    secs = t + FINAL_EPOCH_OFFSET;
-    days = secs / 86400;
-    remsecs = secs % 86400;
-    if (remsecs < 0) {
-        remsecs += 86400;
-        days--;
+// A Ripple epoch time is at most 2^32 - 1 seconds after 2000-01-01, in 2136, so
+// everything fits in 32 bits and there is no negative time to deal with.
+static void ripple_epoch_to_date_time(uint32_t t, dateTime_t *date_time) {
+    uint32_t days = t / SECONDS_PER_DAY;
+    uint32_t seconds = t - days * SECONDS_PER_DAY;
+
+    // Position in the 400 year cycle, the Ripple epoch is in the first one and 2136 in
+    // the second one
+    uint32_t cycle_days = days + RIPPLE_EPOCH_DAYS;
+    uint32_t cycles = 0;
+    if (cycle_days >= DAYS_PER_400Y) {
+        cycle_days -= DAYS_PER_400Y;
+        cycles = 1;
     }
 
-    qc_cycles = days / DAYS_PER_400Y;
-    remdays = days % DAYS_PER_400Y;
-    if (remdays < 0) {
-        remdays += DAYS_PER_400Y;
-        qc_cycles--;
-    }
-
-    c_cycles = remdays / DAYS_PER_100Y;
-    if (c_cycles == 4) c_cycles--;
-    remdays -= c_cycles * DAYS_PER_100Y;
-
-    q_cycles = remdays / DAYS_PER_4Y;
-    if (q_cycles == 25) q_cycles--;
-    remdays -= q_cycles * DAYS_PER_4Y;
-
-    remyears = remdays / 365;
-    if (remyears == 4) remyears--;
-    remdays -= remyears * 365;
+    // Years since the start of the cycle, accounting for the missing leap days every 100
+    // years except every 400 years
+    uint32_t years =
+        (cycle_days - cycle_days / 1460 + cycle_days / 36524 - cycle_days / 146096) / 365;
+    uint32_t year_days = cycle_days - (365 * years + years / 4 - years / 100);
 
-    years = remyears + 4 * q_cycles + 100 * c_cycles + 400 * qc_cycles;
-
-    for (months = 0; days_in_month[months] <= remdays; months++) remdays -= days_in_month[months];
-
-    if (years + 100 > INT_MAX || years + 100 < INT_MIN) return -1;
+    uint8_t month = 11;
+    while (year_days < month_start_days[month]) {
+        month--;
+    }
 
-    tm->tm_year = years + 100;
-    tm->tm_mon = months + 2;
-    if (tm->tm_mon >= 12) {
-        tm->tm_mon -= 12;
-        tm->tm_year++;
+    date_time->day = year_days - month_start_days[month] + 1;
+    if (month < 10) {
+        date_time->month = month + 3;
+        date_time->year = 1600 + 400 * cycles + years;
+    } else {
+        // January and February belong to the next calendar year
+        date_time->month = month - 9;
+        date_time->year = 1600 + 400 * cycles + years + 1;
     }
-    tm->tm_mday = remdays + 1;
 
-    tm->tm_hour = remsecs / 3600;
-    tm->tm_min = remsecs / 60 % 60;
-    tm->tm_sec = remsecs % 60;
+    date_time->hour = seconds / 3600;
+    seconds -= date_time->hour * 3600;
+    date_time->minute = seconds / 60;
+    date_time->second = seconds - date_time->minute * 60;
+}
+
+static char *print_2_digits(char *p, uint8_t value) {
+    uint8_t tens = (value * 103) >> 10;  // value / 10, exact below 179
 
-    return 0;
+    *p++ = '0' + tens;
+    *p++ = '0' + (value - tens * 10);
+    return p;
 }
 
-static void print_time(tm_mini_t *tm, field_value_t *dst) {
-    snprintf(dst->buf,
-             sizeof(dst->buf),
-             "%u-%02u-%02u %02u:%02u:%02u UTC",
-             tm->tm_year + 1900,
-             tm->tm_mon + 1,
-             tm->tm_mday,
-             tm->tm_hour,
-             tm->tm_min,
-             tm->tm_sec);
+// YYYY-MM-DD HH:MM:SS UTC, built two digits at a time and written at once
+static void print_time(const dateTime_t *date_time, textWriter_t *out) {
+    char text[sizeof("YYYY-MM-DD HH:MM:SS UTC") - 1];
+    char *p = text;
+
+    p = print_2_digits(p, date_time->year / 100);
+    p = print_2_digits(p, date_time->year % 100);
+    *p++ = '-';
+    p = print_2_digits(p, date_time->month);
+    *p++ = '-';
+    p = print_2_digits(p, date_time->day);
+    *p++ = ' ';
+    p = print_2_digits(p, date_time->hour);
+    *p++ = ':';
+    p = print_2_digits(p, date_time->minute);
+    *p++ = ':';
+    p = print_2_digits(p, date_time->second);
+    memcpy(p, " UTC", 4);
+    p += 4;
+
+    write_chars(out, text, p - text);
 }
 
-void format_time(field_t *field, field_value_t *dst) {
-    uint32_t value = field->data.u32;
+void format_time(parseContext_t *context, field_t *field, textWriter_t *out) {
+    uint32_t value = field_u32(context, field);
 
-    tm_mini_t tm;
-    ripple_epoch_to_tm(value, &tm);
+    dateTime_t date_time;
+    ripple_epoch_to_date_time(value, &date_time);
 
-    print_time(&tm, dst);
+    print_time(&date_time, out);
 }
 
-void format_time_delta(field_t *field, field_value_t *dst) {
-    uint32_t value = field->data.u32;
-    snprintf(dst->buf, sizeof(dst->buf), "%u s", value);
+void format_time_delta(parseContext_t *context, field_t *field, textWriter_t *out) {
+    write_uint(out, field_u32(context, field));
+    write_string(out, " s");
 }
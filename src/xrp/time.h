@@ -20,10 +20,11 @@
 
 #include <stdbool.h>
 #include "fields.h"
+#include "text_writer.h"
 
 bool is_time(field_t* field);
 bool is_time_delta(field_t* field);
-void format_time(field_t* field, field_value_t* dst);
-void format_time_delta(field_t* field, field_value_t* dst);
+void format_time(parseContext_t* context, field_t* field, textWriter_t* out);
+void format_time_delta(parseContext_t* context, field_t* field, textWriter_t* out);
 
 #endif  // LEDGER_APP_XRP_TIME_H
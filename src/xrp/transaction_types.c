@@ -0,0 +1,140 @@
+/*******************************************************************************
+ *   XRP Wallet
+ *   (c) 2020 Towo Labs
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+#include "os.h"
+
+#include "transaction_types.h"
+#include "field_info.h"
+
+#define SF(field) (1ull << SCHEMA_##field)
+
+static const transactionInfo_t transaction_infos[] = {
+    [TRANSACTION_PAYMENT] = {"Payment",
+                             FLAG_SET_PAYMENT,
+                             SF(AMOUNT) | SF(DESTINATION),
+                             SF(DESTINATION_TAG) | SF(INVOICE_ID) | SF(SEND_MAX) | SF(DELIVER_MIN) |
+                             SF(PATHS)},
+    [TRANSACTION_ESCROW_CREATE] = {"Create Escrow",
+                                   FLAG_SET_NONE,
+                                   SF(AMOUNT) | SF(DESTINATION),
+                                   SF(DESTINATION_TAG) | SF(FINISH_AFTER) | SF(CANCEL_AFTER) |
+                                   SF(CONDITION)},
+    [TRANSACTION_ESCROW_FINISH] = {"Finish Escrow",
+                                   FLAG_SET_NONE,
+                                   SF(OWNER) | SF(OFFER_SEQUENCE),
+                                   SF(CONDITION) | SF(FULFILLMENT)},
+    [TRANSACTION_ACCOUNT_SET] = {"Account Setting",
+                                 FLAG_SET_ACCOUNT_SET,
+                                 0,
+                                 SF(SET_FLAG) | SF(CLEAR_FLAG) | SF(DOMAIN) | SF(EMAIL_HASH) |
+                                 SF(MESSAGE_KEY) | SF(TRANSFER_RATE) | SF(TICK_SIZE) |
+                                 SF(WALLET_LOCATOR) | SF(WALLET_SIZE) | SF(NFTOKEN_MINTER)},
+    [TRANSACTION_ESCROW_CANCEL] = {"Cancel Escrow",
+                                   FLAG_SET_NONE,
+                                   SF(OWNER) | SF(OFFER_SEQUENCE),
+                                   0},
+    [TRANSACTION_SET_REGULAR_KEY] = {"Set Regular Key", FLAG_SET_NONE, 0, SF(REGULAR_KEY)},
+    [TRANSACTION_OFFER_CREATE] = {"Create Offer",
+                                  FLAG_SET_OFFER_CREATE,
+                                  SF(TAKER_PAYS) | SF(TAKER_GETS),
+                                  SF(EXPIRATION) | SF(OFFER_SEQUENCE)},
+    [TRANSACTION_OFFER_CANCEL] = {"Cancel Offer", FLAG_SET_NONE, SF(OFFER_SEQUENCE), 0},
+    [TRANSACTION_TICKET_CREATE] = {"Create Ticket", FLAG_SET_NONE, SF(TICKET_COUNT), 0},
+    [TRANSACTION_SIGNER_LIST_SET] = {"Set Signer List",
+                                     FLAG_SET_NONE,
+                                     SF(SIGNER_QUORUM),
+                                     SF(SIGNER_ENTRIES)},
+    [TRANSACTION_PAYMENT_CHANNEL_CREATE] = {"Create Channel",
+                                            FLAG_SET_NONE,
+                                            SF(AMOUNT) | SF(DESTINATION) | SF(SETTLE_DELAY) |
+                                            SF(PUBLIC_KEY),
+                                            SF(CANCEL_AFTER) | SF(DESTINATION_TAG)},
+    [TRANSACTION_PAYMENT_CHANNEL_FUND] = {"Fund Channel",
+                                          FLAG_SET_NONE,
+                                          SF(CHANNEL) | SF(AMOUNT),
+                                          SF(EXPIRATION)},
+    [TRANSACTION_PAYMENT_CHANNEL_CLAIM] = {"Channel Claim",
+                                           FLAG_SET_PAYMENT_CHANNEL_CLAIM,
+                                           SF(CHANNEL),
+                                           SF(BALANCE) | SF(AMOUNT) | SF(SIGNATURE) |
+                                           SF(PUBLIC_KEY)},
+    [TRANSACTION_CHECK_CREATE] = {"Create Check",
+                                  FLAG_SET_NONE,
+                                  SF(DESTINATION) | SF(SEND_MAX),
+                                  SF(DESTINATION_TAG) | SF(EXPIRATION) | SF(INVOICE_ID)},
+    [TRANSACTION_CHECK_CASH] = {"Cash Check",
+                                FLAG_SET_NONE,
+                                SF(CHECK_ID),
+                                SF(AMOUNT) | SF(DELIVER_MIN)},
+    [TRANSACTION_CHECK_CANCEL] = {"Cancel Check", FLAG_SET_NONE, SF(CHECK_ID), 0},
+    [TRANSACTION_DEPOSIT_PREAUTH] = {"Preauth. Deposit",
+                                     FLAG_SET_NONE,
+                                     0,
+                                     SF(AUTHORIZE) | SF(UNAUTHORIZE)},
+    [TRANSACTION_TRUST_SET] = {"Set Trust Line",
+                               FLAG_SET_TRUST_SET,
+                               SF(LIMIT_AMOUNT),
+                               SF(QUALITY_IN) | SF(QUALITY_OUT)},
+    [TRANSACTION_ACCOUNT_DELETE] = {"Delete Account",
+                                    FLAG_SET_NONE,
+                                    SF(DESTINATION),
+                                    SF(DESTINATION_TAG)},
+    [TRANSACTION_NFTOKEN_MINT] = {"Mint NFToken",
+                                  FLAG_SET_NFTOKEN_MINT,
+                                  SF(NFTOKEN_TAXON),
+                                  SF(ISSUER) | SF(TRANSFER_FEE) | SF(URI) | SF(AMOUNT) |
+                                  SF(DESTINATION) | SF(EXPIRATION)},
+    [TRANSACTION_NFTOKEN_BURN] = {"Burn NFToken", FLAG_SET_NONE, SF(NFTOKEN_ID), SF(OWNER)},
+    [TRANSACTION_NFTOKEN_CREATE_OFFER] = {"Create NFT Offer",
+                                          FLAG_SET_NFTOKEN_CREATE_OFFER,
+                                          SF(NFTOKEN_ID) | SF(AMOUNT),
+                                          SF(OWNER) | SF(EXPIRATION) | SF(DESTINATION)},
+    [TRANSACTION_NFTOKEN_CANCEL_OFFER] = {"Cancel NFT Offer", FLAG_SET_NONE, SF(NFTOKEN_OFFERS), 0},
+    [TRANSACTION_NFTOKEN_ACCEPT_OFFER] = {"Accept NFT Offer",
+                                          FLAG_SET_NONE,
+                                          0,
+                                          SF(NFTOKEN_SELL_OFFER) | SF(NFTOKEN_BUY_OFFER) |
+                                          SF(NFTOKEN_BROKER_FEE)},
+    [TRANSACTION_CLAWBACK] = {"Clawback", FLAG_SET_NONE, SF(AMOUNT), 0},
+    [TRANSACTION_AMM_CREATE] = {"Create AMM", FLAG_SET_NONE, 0, SCHEMA_ANY},
+    [TRANSACTION_AMM_DEPOSIT] = {"Deposit to AMM", FLAG_SET_NONE, 0, SCHEMA_ANY},
+    [TRANSACTION_AMM_WITHDRAW] = {"Withdraw from AMM", FLAG_SET_NONE, 0, SCHEMA_ANY},
+    [TRANSACTION_AMM_VOTE] = {"Vote on AMM", FLAG_SET_NONE, 0, SCHEMA_ANY},
+    [TRANSACTION_AMM_BID] = {"Bid on AMM", FLAG_SET_NONE, 0, SCHEMA_ANY},
+    [TRANSACTION_AMM_DELETE] = {"Delete AMM", FLAG_SET_NONE, 0, SCHEMA_ANY},
+    [TRANSACTION_XCHAIN_CREATE_CLAIM_ID] = {"XChain Claim ID", FLAG_SET_NONE, 0, SCHEMA_ANY},
+    [TRANSACTION_XCHAIN_COMMIT] = {"XChain Commit", FLAG_SET_NONE, 0, SCHEMA_ANY},
+    [TRANSACTION_XCHAIN_CLAIM] = {"XChain Claim", FLAG_SET_NONE, 0, SCHEMA_ANY},
+    [TRANSACTION_XCHAIN_ACCOUNT_CREATE] = {"XChain Create Acc.", FLAG_SET_NONE, 0, SCHEMA_ANY},
+    [TRANSACTION_XCHAIN_CLAIM_ATTEST] = {"XChain Attestation", FLAG_SET_NONE, 0, SCHEMA_ANY},
+    [TRANSACTION_XCHAIN_ACCOUNT_ATTEST] = {"XChain Acc. Attest.", FLAG_SET_NONE, 0, SCHEMA_ANY},
+    [TRANSACTION_XCHAIN_MODIFY_BRIDGE] = {"Modify Bridge", FLAG_SET_NONE, 0, SCHEMA_ANY},
+    [TRANSACTION_XCHAIN_CREATE_BRIDGE] = {"Create Bridge", FLAG_SET_NONE, 0, SCHEMA_ANY},
+    [TRANSACTION_DID_SET] = {"Set DID", FLAG_SET_NONE, 0, SCHEMA_ANY},
+    [TRANSACTION_DID_DELETE] = {"Delete DID", FLAG_SET_NONE, 0, SCHEMA_ANY},
+};
+
+const transactionInfo_t *get_transaction_info(uint16_t transaction_type) {
+    static const transactionInfo_t unknown = {"Unknown", FLAG_SET_NONE, 0, SCHEMA_ANY};
+
+    if (transaction_type >= sizeof(transaction_infos) / sizeof(transaction_infos[0]) ||
+        transaction_infos[transaction_type].name == NULL) {
+        return &unknown;
+    }
+
+    return &transaction_infos[transaction_type];
+}
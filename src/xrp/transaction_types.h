@@ -19,8 +19,10 @@
 #define LEDGER_APP_XRP_TRANSACTIONTYPES_H
 
 #include <stdbool.h>
+#include <stdint.h>
 
-#include "xrp_parse.h"
+#include "fields.h"
+#include "flags.h"
 
 #define TRANSACTION_INVALID                0xFFFF
 #define TRANSACTION_PAYMENT                0
@@ -31,6 +33,7 @@
 #define TRANSACTION_SET_REGULAR_KEY        5
 #define TRANSACTION_OFFER_CREATE           7
 #define TRANSACTION_OFFER_CANCEL           8
+#define TRANSACTION_TICKET_CREATE          10
 #define TRANSACTION_SIGNER_LIST_SET        12
 #define TRANSACTION_PAYMENT_CHANNEL_CREATE 13
 #define TRANSACTION_PAYMENT_CHANNEL_FUND   14
@@ -41,6 +44,43 @@
 #define TRANSACTION_DEPOSIT_PREAUTH        19
 #define TRANSACTION_TRUST_SET              20
 #define TRANSACTION_ACCOUNT_DELETE         21
+#define TRANSACTION_NFTOKEN_MINT           25
+#define TRANSACTION_NFTOKEN_BURN           26
+#define TRANSACTION_NFTOKEN_CREATE_OFFER   27
+#define TRANSACTION_NFTOKEN_CANCEL_OFFER   28
+#define TRANSACTION_NFTOKEN_ACCEPT_OFFER   29
+#define TRANSACTION_CLAWBACK               30
+#define TRANSACTION_AMM_CREATE             35
+#define TRANSACTION_AMM_DEPOSIT            36
+#define TRANSACTION_AMM_WITHDRAW           37
+#define TRANSACTION_AMM_VOTE               38
+#define TRANSACTION_AMM_BID                39
+#define TRANSACTION_AMM_DELETE             40
+#define TRANSACTION_XCHAIN_CREATE_CLAIM_ID 41
+#define TRANSACTION_XCHAIN_COMMIT          42
+#define TRANSACTION_XCHAIN_CLAIM           43
+#define TRANSACTION_XCHAIN_ACCOUNT_CREATE  44
+#define TRANSACTION_XCHAIN_CLAIM_ATTEST    45
+#define TRANSACTION_XCHAIN_ACCOUNT_ATTEST  46
+#define TRANSACTION_XCHAIN_MODIFY_BRIDGE   47
+#define TRANSACTION_XCHAIN_CREATE_BRIDGE   48
+#define TRANSACTION_DID_SET                49
+#define TRANSACTION_DID_DELETE             50
+
+// Schema of transaction types whose fields aren't checked
+#define SCHEMA_ANY UINT64_MAX
+
+// What the app knows about a transaction type, indexed by its code. The transaction
+// specific fields are given as bitmasks of schemaField_t.
+typedef struct {
+    const char *name;
+    uint8_t flag_set;   // flagSet_t, how the Flags field is displayed
+    uint64_t required;  // Must be present
+    uint64_t optional;  // May be present, or SCHEMA_ANY
+} transactionInfo_t;
+
+// Unknown transaction types are named "Unknown" and have no flags
+const transactionInfo_t *get_transaction_info(uint16_t transaction_type);
 
 static inline bool is_transaction_type_field(field_t *field) {
     return field->data_type == STI_UINT16 && field->id == XRP_UINT16_TRANSACTION_TYPE;
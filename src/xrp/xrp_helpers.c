@@ -34,48 +34,106 @@ static const char bas_e58_alphabet[] = {'r', 'p', 's', 'h', 'n', 'a', 'f', '3',
                                         'd', 'e', 'C', 'g', '6', '5', 'j', 'k', 'm', '8', 'o', 'F',
                                         'q', 'i', '1', 't', 'u', 'v', 'A', 'x', 'y', 'z'};
 
-static size_t xrp_encode_base58_address(const base58_buf_t *in, xrp_address_t *out) {
-    unsigned char buffer[MAX_ENC_INPUT_SIZE * 138 / 100 + 1] = {0};
-    size_t i = 0, j;
-    size_t start_at, stop_at;
+// The payload is encoded in limbs of two base58 digits, which keeps every intermediate value
+// within 32 bits and replaces the quadratic digit by digit conversion with one multiply
+// accumulate per byte and limb.
+#define BASE58_LIMB       3364  // 58^2
+#define BASE58_LIMB_COUNT 18    // 3364^18 > 256^MAX_ENC_INPUT_SIZE
+
+// base58_weights[i] is 256^i in base 3364, least significant limb first
+static const uint16_t base58_weights[MAX_ENC_INPUT_SIZE][BASE58_LIMB_COUNT] = {
+    {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {256, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {1620, 19, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {948, 1623, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {480, 1788, 379, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {1776, 260, 2968, 28, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {516, 2779, 2927, 665, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {900, 1659, 2715, 2262, 562, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {1648, 908, 2182, 670, 2756, 42, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {1388, 457, 237, 122, 2511, 869, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {2108, 2721, 154, 974, 301, 631, 834, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {1408, 388, 2627, 419, 3122, 86, 1620, 63, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {500, 1879, 3105, 3179, 1995, 2069, 954, 2795, 4, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {168, 10, 1119, 3336, 2997, 1667, 2173, 2424, 1236, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {2640, 2572, 524, 3009, 493, 3116, 1354, 1733, 384, 94, 0, 0, 0, 0, 0, 0, 0, 0},
+    {3040, 2652, 3143, 3351, 1968, 465, 369, 3067, 879, 545, 7, 0, 0, 0, 0, 0, 0, 0},
+    {1156, 2979, 813, 275, 2827, 1449, 307, 1368, 3233, 1662, 1833, 0, 0, 0, 0, 0, 0, 0},
+    {3268, 2447, 3150, 3181, 472, 1119, 1330, 375, 208, 1854, 1778, 139, 0, 0, 0, 0, 0, 0},
+    {2336, 976, 2590, 487, 3334, 559, 801, 1909, 2816, 315, 1169, 2079, 10, 0, 0, 0, 0, 0},
+    {2588, 1097, 406, 401, 2449, 2069, 3258, 984, 1145, 118, 3256, 800, 2718, 0, 0, 0, 0, 0},
+    {3184, 1816, 3099, 1766, 1270, 1702, 3297, 3215, 526, 19, 2637, 3207, 2884, 206, 0, 0, 0, 0},
+    {1016, 906, 2942, 1555, 2310, 1852, 3161, 2474, 340, 1540, 2273, 376, 1832, 2495, 15, 0, 0, 0},
+    {1068, 3261, 3048, 1351, 2778, 3327, 1996, 1152, 3128, 677, 33, 2237, 1424, 3063, 665, 1, 0, 0},
+    {924, 625, 88, 2960, 1466, 831, 3265, 2395, 223, 1986, 1771, 794, 1402, 424, 2273, 306, 0, 0},
+    {1064, 1962, 2391, 866, 2117, 915, 1631, 1120, 82, 469, 2751, 1558, 2388, 1002, 3312, 1136, 23,
+     0},
+    {3264, 1116, 3361, 3217, 413, 2285, 469, 904, 893, 2330, 1215, 2105, 2562, 1029, 220, 1764,
+     2610, 1},
+};
+
+static inline size_t encode_base58_limbs(const uint8_t *in, size_t length, xrp_address_t *out) {
+    uint32_t limbs[BASE58_LIMB_COUNT] = {0};
+    uint8_t digits[2 * BASE58_LIMB_COUNT];
     size_t zero_count = 0;
-    size_t output_size;
-    size_t outlen = sizeof(out->buf);
+    size_t i, j, k;
 
-    while ((zero_count < in->length) && (in->buf[zero_count] == 0)) {
+    while ((zero_count < length) && (in[zero_count] == 0)) {
         ++zero_count;
     }
 
-    output_size = (in->length - zero_count) * 138 / 100 + 1;
-    stop_at = output_size - 1;
-    for (start_at = zero_count; start_at < in->length; start_at++) {
-        int carry = in->buf[start_at];
-        for (j = output_size - 1; (int) j >= 0; j--) {
-            carry += 256 * buffer[j];
-            buffer[j] = carry % 58;
-            carry /= 58;
-
-            if (j <= stop_at - 1 && carry == 0) {
-                break;
-            }
+    // Each sum stays below MAX_ENC_INPUT_SIZE * 255 * 3363, far from overflowing
+    for (i = 0; i < length - zero_count; i++) {
+        uint32_t byte = in[length - 1 - i];
+        if (byte == 0) {
+            continue;
         }
-        stop_at = j;
+
+        // 256^i < 3364^(8i/11 + 1), the remaining limbs of the weight are zero
+        size_t limb_count = i * 8 / 11 + 1;
+        if (limb_count > BASE58_LIMB_COUNT) {
+            limb_count = BASE58_LIMB_COUNT;
+        }
+
+        for (k = 0; k < limb_count; k++) {
+            limbs[k] += byte * base58_weights[i][k];
+        }
+    }
+
+    uint32_t carry = 0;
+    for (k = 0; k < BASE58_LIMB_COUNT; k++) {
+        uint32_t value = limbs[k] + carry;
+        carry = value / BASE58_LIMB;
+        value -= carry * BASE58_LIMB;
+
+        // (value * 1130) >> 16 equals value / 58 for every value below 3364
+        uint32_t high = (value * 1130) >> 16;
+        digits[2 * k] = value - high * 58;
+        digits[2 * k + 1] = high;
     }
 
-    j = 0;
-    while (j < output_size && buffer[j] == 0) {
-        j += 1;
+    j = sizeof(digits);
+    while (j > 0 && digits[j - 1] == 0) {
+        j -= 1;
     }
 
     memset(out, bas_e58_alphabet[0], zero_count);
 
     i = zero_count;
-    while (j < output_size) {
-        out->buf[i++] = bas_e58_alphabet[buffer[j++]];
+    while (j > 0) {
+        out->buf[i++] = bas_e58_alphabet[digits[--j]];
     }
-    outlen = i;
 
-    return outlen;
+    return i;
+}
+
+static size_t xrp_encode_base58_address(const base58_buf_t *in, xrp_address_t *out) {
+    // Classic addresses are always 25 bytes, let the compiler specialise that case
+    if (in->length == 25) {
+        return encode_base58_limbs(in->buf, 25, out);
+    }
+
+    return encode_base58_limbs(in->buf, in->length, out);
 }
 
 cx_err_t xrp_public_key_hash160(xrp_pubkey_t *pubkey, uint8_t *out) {
@@ -248,27 +306,17 @@ bool adjust_decimals(const char *src,
 
 /* return -1 on error, 0 otherwise */
 int xrp_print_amount(uint64_t amount, char *out, size_t outlen) {
-    char tmp[20];
-    uint32_t num_digits = 0, i;
-    uint64_t base;
-
-    for (base = 1; base <= amount; base *= 10) {
-        num_digits++;
-        if (num_digits > sizeof(tmp) - 1) {
-            return -1;
-        }
-    }
+    char tmp[MAX_DECIMAL_DIGITS];
+    uint8_t num_digits = decimal_digits(amount, tmp);
 
-    base /= 10;
-    for (i = 0; i < num_digits; i++) {
-        tmp[i] = int_to_number_char((amount / base) % 10);
-        base /= 10;
+    // 19 digits at most, up to 9999999999999.999999 XRP
+    if (num_digits > MAX_DECIMAL_DIGITS - 1) {
+        return -1;
     }
-    tmp[i] = '\0';
 
     char tmp2[25];
     strncpy(tmp2, CURRENCY, sizeof(tmp2));
-    if (!adjust_decimals(tmp, i, tmp2 + CURRENCY_SIZE, sizeof(tmp2) - CURRENCY_SIZE, 6)) {
+    if (!adjust_decimals(tmp, num_digits, tmp2 + CURRENCY_SIZE, sizeof(tmp2) - CURRENCY_SIZE, 6)) {
         return -1;
     }
 
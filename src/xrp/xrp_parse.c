@@ -23,6 +23,7 @@
 #include "amount.h"
 #include "array.h"
 #include "fields.h"
+#include "field_info.h"
 #include "readers.h"
 #include "transaction_types.h"
 #include "field_sort.h"
@@ -41,15 +42,16 @@ static bool has_data(parseContext_t *context, uint32_t num_bytes) {
     return context->offset + num_bytes - 1 < context->length;
 }
 
-static bool has_field(parseContext_t *context, field_type_t data_type, uint8_t id) {
-    for (uint8_t i = 0; i < context->result.num_fields; ++i) {
-        field_t *field = &context->result.fields[i];
-        if (field->data_type == data_type && field->id == id) {
-            return true;
-        }
+static bool is_tracked_field(field_type_t data_type, uint8_t id) {
+    return data_type >= STI_UINT16 && data_type <= STI_ACCOUNT && id < 32;
+}
+
+bool has_field(parseContext_t *context, field_type_t data_type, uint8_t id) {
+    if (!is_tracked_field(data_type, id)) {
+        return false;
     }
 
-    return false;
+    return (context->seen_fields[data_type - 1] & (1u << id)) != 0;
 }
 
 uint8_t *current_position(parseContext_t *context) {
@@ -58,8 +60,29 @@ uint8_t *current_position(parseContext_t *context) {
 
 typedef struct err_s {
     int err;
+    uint8_t reason;  // parseReason_t, only set on failure
 } err_t;
 
+static err_t parse_error(int code, parseReason_t reason) {
+    err_t err;
+    err.err = code;
+    err.reason = reason;
+    return err;
+}
+
+// Record where parsing failed, see parseError_t
+static err_t parse_failure(parseContext_t *context,
+                           err_t err,
+                           uint32_t offset,
+                           uint8_t data_type,
+                           uint8_t id) {
+    context->error.offset = offset;
+    context->error.data_type = data_type;
+    context->error.id = id;
+    context->error.reason = err.reason;
+    return err;
+}
+
 err_t advance_position(parseContext_t *context, uint32_t num_bytes) {
     err_t err;
 
@@ -67,7 +90,7 @@ err_t advance_position(parseContext_t *context, uint32_t num_bytes) {
         context->offset += num_bytes;
         err.err = SUCCESS;
     } else {
-        err.err = EXCEPTION_OVERFLOW;
+        err = parse_error(EXCEPTION_OVERFLOW, PARSE_REASON_TRUNCATED);
     }
 
     return err;
@@ -80,7 +103,7 @@ err_t read_next_byte(parseContext_t *context, uint8_t *result) {
         *result = *current_position(context);
         err = advance_position(context, 1);
     } else {
-        err.err = EXCEPTION_OVERFLOW;
+        err = parse_error(EXCEPTION_OVERFLOW, PARSE_REASON_TRUNCATED);
     }
 
     return err;
@@ -93,25 +116,34 @@ err_t peak_next_byte(parseContext_t *context, uint8_t *result) {
         *result = *current_position(context);
         err.err = SUCCESS;
     } else {
-        err.err = EXCEPTION_OVERFLOW;
+        err = parse_error(EXCEPTION_OVERFLOW, PARSE_REASON_TRUNCATED);
     }
 
     return err;
 }
 
+static parseFrame_t *current_frame(parseContext_t *context) {
+    return &context->frames[context->depth];
+}
+
 void append_array_info(parseContext_t *context, field_t *field) {
-    if (context->current_array != 0) {
-        field->array_info.type = context->current_array;
-        field->array_info.index1 = context->array_index1;
-        field->array_info.index2 = context->array_index2;
+    // The displayed index is the one of the innermost array
+    for (uint8_t depth = context->depth; depth > 0; --depth) {
+        parseFrame_t *frame = &context->frames[depth];
+        if (frame->array != ARRAY_NONE) {
+            field->array_info.type = frame->array;
+            field->array_info.index1 = frame->index1;
+            field->array_info.index2 = frame->index2;
+            return;
+        }
     }
 }
 
 err_t append_new_field(parseContext_t *context, field_t **field) {
     err_t err;
 
-    if (context->result.num_fields >= MAX_FIELD_COUNT) {
-        err.err = NOT_ENOUGH_SPACE;
+    if (context->result.num_fields >= RESULT_FIELD_COUNT) {
+        err = parse_error(NOT_ENOUGH_SPACE, PARSE_REASON_TOO_MANY_FIELDS);
         return err;
     }
 
@@ -122,32 +154,29 @@ err_t append_new_field(parseContext_t *context, field_t **field) {
     return err;
 }
 
-err_t remove_last_field(parseContext_t *context, field_t *last_field) {
+// Store a decoded field before the fields that were appended while decoding it,
+// such as the issuer of an amount
+static err_t insert_field(parseContext_t *context, uint8_t index, field_t *field) {
     err_t err;
 
-    if (context->result.num_fields == 0) {
-        err.err = INVALID_STATE;
+    if (context->result.num_fields >= RESULT_FIELD_COUNT) {
+        err = parse_error(NOT_ENOUGH_SPACE, PARSE_REASON_TOO_MANY_FIELDS);
         return err;
     }
 
-    // Verify that the last field in the array corresponds to the field that we
-    // are supposed to remove.
-    if (&context->result.fields[context->result.num_fields - 1] != last_field) {
-        err.err = INVALID_STATE;
-        return err;
-    }
-
-    // Make sure that all data is cleared so that we don't end up with
-    // an unexpected state later on.
-    memset(last_field, 0, sizeof(field_t));
-    context->result.num_fields--;
+    field_t *fields = context->result.fields;
+    memmove(&fields[index + 1],
+            &fields[index],
+            (context->result.num_fields - index) * sizeof(field_t));
+    fields[index] = *field;
+    context->result.num_fields++;
 
     err.err = SUCCESS;
     return err;
 }
 
 err_t read_fixed_size_field(parseContext_t *context, field_t *field, uint16_t length) {
-    field->data.ptr = current_position(context);
+    field->offset = context->offset;
     field->length = length;
 
     return advance_position(context, length);
@@ -165,7 +194,7 @@ err_t read_variable_length_field(parseContext_t *context, field_t *field) {
             // It is impossible to send a transaction large enough to
             // hold a field with a length of 12481 or greater, so we
             // should never reach this point with a valid transaction
-            err.err = INVALID_STATE;
+            err = parse_error(INVALID_STATE, PARSE_REASON_LENGTH_TOO_LARGE);
             return err;
         }
 
@@ -187,12 +216,12 @@ err_t read_amount(parseContext_t *context, field_t *field) {
     } else {
         CHECK(read_fixed_size_field(context, field, ISSUED_CURRENCY_LEN));
 
-        if (has_non_standard_currency(field)) {
+        if (has_non_standard_currency(context, field)) {
             field_t *currency;
             CHECK(append_new_field(context, &currency));
             currency->data_type = STI_CURRENCY;
             currency->id = XRP_CURRENCY_CURRENCY;
-            currency->data.currency = (xrp_currency_t *) (field->data.ptr + 8);
+            currency->offset = field->offset + 8;
             currency->length = XRP_CURRENCY_SIZE;
         }
 
@@ -200,41 +229,77 @@ err_t read_amount(parseContext_t *context, field_t *field) {
         CHECK(append_new_field(context, &issuer));
         issuer->data_type = STI_ACCOUNT;
         issuer->id = XRP_ACCOUNT_ISSUER;
-        issuer->data.account = (xrp_account_t *) (field->data.ptr + 28);
+        issuer->offset = field->offset + 28;
         issuer->length = XRP_ACCOUNT_SIZE;
     }
 
     return err;
 }
 
-void handle_array_field(parseContext_t *context, field_t *field) {
+static err_t push_frame(parseContext_t *context, uint8_t array) {
+    err_t err;
+
+    if (context->depth >= MAX_NESTING_DEPTH) {
+        err = parse_error(NOT_SUPPORTED, PARSE_REASON_TOO_DEEP);
+        return err;
+    }
+
+    parseFrame_t *frame = &context->frames[++context->depth];
+    frame->array = array;
+    frame->index1 = 0;
+    frame->index2 = 0;
+    frame->last_field = 0;
+
+    err.err = SUCCESS;
+    return err;
+}
+
+err_t handle_array_field(parseContext_t *context, field_t *field) {
+    err_t err;
+
     if (field->id != ARR_END) {
         // Begin array
-        context->current_array = field->id;
-        context->array_index1 = 0;
-        context->array_index2 = 0;
-    } else {
-        // End array
-        context->current_array = ARRAY_NONE;
+        return push_frame(context, field->id);
+    }
+
+    // End array
+    if (context->depth == 0 || current_frame(context)->array == ARRAY_NONE) {
+        err = parse_error(INVALID_STATE, PARSE_REASON_UNEXPECTED_END);
+        return err;
     }
+    context->depth--;
+
+    err.err = SUCCESS;
+    return err;
 }
 
 err_t handle_object_field(parseContext_t *context, field_t *field) {
     err_t err;
+    parseFrame_t *frame = current_frame(context);
+
+    if (field->id == OBJ_END) {
+        if (context->depth == 0 || frame->array != ARRAY_NONE) {
+            err = parse_error(INVALID_STATE, PARSE_REASON_UNEXPECTED_END);
+            return err;
+        }
+        context->depth--;
+
+        err.err = SUCCESS;
+        return err;
+    }
 
-    if (field->id != OBJ_END) {
-        // Normal object, only increment first array index
-        context->array_index1++;
+    if (frame->array != ARRAY_NONE) {
+        // New array item
+        frame->index1++;
 
         // Explicitly limit the maximum number of array items
-        if (context->array_index1 > MAX_ARRAY_LEN) {
-            err.err = NOT_SUPPORTED;
+        if (frame->index1 > MAX_ARRAY_LEN) {
+            err = parse_error(NOT_SUPPORTED, PARSE_REASON_TOO_MANY_ITEMS);
             return err;
         }
     }
 
-    err.err = SUCCESS;
-    return err;
+    return push_frame(context, ARRAY_NONE);
 }
 
 err_t handle_path_step(parseContext_t *context, field_t *field, uint8_t step_type) {
@@ -276,31 +341,32 @@ err_t handle_path_field(parseContext_t *context, field_t *field) {
     // Set default type to STI_PATHSET, which is hidden
     field->data_type = STI_PATHSET;
 
+    parseFrame_t *frame = current_frame(context);
     uint8_t current_step;
     err_t err;
     CHECK(read_next_byte(context, &current_step));
     switch (current_step) {
         case PATHSET_NEXT:
             // Indicator for next item. Increase index and continue parsing
-            context->array_index1++;
-            context->array_index2 = 1;
+            frame->index1++;
+            frame->index2 = 1;
 
             // Limit the number of paths to the specified maximum
-            if (context->array_index1 > MAX_PATH_COUNT) {
-                err.err = INVALID_STATE;
+            if (frame->index1 > MAX_PATH_COUNT) {
+                err = parse_error(INVALID_STATE, PARSE_REASON_TOO_MANY_PATHS);
                 return err;
             }
 
             break;
         case PATHSET_END:
             // End of path set, stop parsing
-            context->current_array = ARRAY_NONE;
+            context->depth--;
             break;
         default:
             // Verify that the step count is within specified bounds before
             // processing the step data
-            if (context->array_index2 > MAX_STEP_COUNT) {
-                err.err = INVALID_STATE;
+            if (frame->index2 > MAX_STEP_COUNT) {
+                err = parse_error(INVALID_STATE, PARSE_REASON_TOO_MANY_STEPS);
                 return err;
             }
 
@@ -309,66 +375,90 @@ err_t handle_path_field(parseContext_t *context, field_t *field) {
 
             // The array index is incremented here because handle_path_step
             // may append more than one field with the same index
-            context->array_index2++;
+            frame->index2++;
             break;
     }
 
     return err;
 }
 
-void handle_path_set_field(parseContext_t *context) {
-    context->current_array = ARRAY_PATHSET;
+err_t handle_path_set_field(parseContext_t *context) {
+    err_t err;
+    CHECK(push_frame(context, ARRAY_PATHSET));
 
     // The code for handling path set fields becomes easier if we
     // begin the arrays at one, which is what we want to present
     // to the user
-    context->array_index1 = 1;
-    context->array_index2 = 1;
+    parseFrame_t *frame = current_frame(context);
+    frame->index1 = 1;
+    frame->index2 = 1;
+
+    return err;
+}
+
+// How the value of each field type is read and how it changes the nesting
+typedef enum {
+    VALUE_UNSUPPORTED = 0,
+    VALUE_FIXED,
+    VALUE_VARIABLE,
+    VALUE_AMOUNT,
+    VALUE_ARRAY,
+    VALUE_OBJECT,
+    VALUE_PATHSET,
+} valueKind_t;
+
+typedef struct {
+    uint8_t kind;       // valueKind_t
+    uint8_t length;     // Length of VALUE_FIXED values
+    bool post_process;  // Whether post_process_field has rules for the type
+} typeDescriptor_t;
+
+static const typeDescriptor_t type_descriptors[] = {
+    [STI_UINT16] = {VALUE_FIXED, 2, true},
+    [STI_UINT32] = {VALUE_FIXED, 4, true},
+    [STI_HASH128] = {VALUE_FIXED, sizeof(hash128_t), false},
+    [STI_HASH256] = {VALUE_FIXED, sizeof(hash256_t), false},
+    [STI_AMOUNT] = {VALUE_AMOUNT, 0, false},
+    [STI_VL] = {VALUE_VARIABLE, 0, true},
+    [STI_ACCOUNT] = {VALUE_VARIABLE, 0, true},
+    [STI_OBJECT] = {VALUE_OBJECT, 0, false},
+    [STI_ARRAY] = {VALUE_ARRAY, 0, false},
+    [STI_UINT8] = {VALUE_FIXED, 1, false},
+    [STI_PATHSET] = {VALUE_PATHSET, 0, false},
+    [STI_VECTOR256] = {VALUE_VARIABLE, 0, false},
+};
+
+static const typeDescriptor_t *get_type_descriptor(uint8_t data_type) {
+    static const typeDescriptor_t unsupported = {VALUE_UNSUPPORTED, 0, false};
+
+    if (data_type >= sizeof(type_descriptors) / sizeof(type_descriptors[0])) {
+        return &unsupported;
+    }
+
+    return &type_descriptors[data_type];
 }
 
-err_t read_field_value(parseContext_t *context, field_t *field) {
+err_t read_field_value(parseContext_t *context, field_t *field, const typeDescriptor_t *type) {
     err_t err;
     err.err = SUCCESS;
 
-    switch (field->data_type) {
-        case STI_UINT8:
-            CHECK(read_fixed_size_field(context, field, 1));
-            field->data.u8 = field->data.ptr[0];
-            break;
-        case STI_UINT16:
-            CHECK(read_fixed_size_field(context, field, 2));
-            field->data.u16 = field->data.ptr[1] | (field->data.ptr[0] << 8);
-            break;
-        case STI_UINT32:
-            CHECK(read_fixed_size_field(context, field, 4));
-            field->data.u32 = field->data.ptr[3] | (field->data.ptr[2] << 8) |
-                              (field->data.ptr[1] << 16) | (field->data.ptr[0] << 24);
-            break;
-        case STI_HASH128:
-            err = read_fixed_size_field(context, field, sizeof(hash128_t));
-            break;
-        case STI_HASH256:
-            err = read_fixed_size_field(context, field, sizeof(hash256_t));
-            break;
-        case STI_AMOUNT:
-            err = read_amount(context, field);
+    switch (type->kind) {
+        case VALUE_FIXED:
+            err = read_fixed_size_field(context, field, type->length);
             break;
-        case STI_VL:
-            // Intentional fall-through
-        case STI_ACCOUNT:
+        case VALUE_VARIABLE:
             err = read_variable_length_field(context, field);
             break;
-        case STI_ARRAY:
-            handle_array_field(context, field);
-            break;
-        case STI_OBJECT:
-            err = handle_object_field(context, field);
+        case VALUE_AMOUNT:
+            err = read_amount(context, field);
             break;
-        case STI_PATHSET:
-            handle_path_set_field(context);
+        case VALUE_ARRAY:
+        case VALUE_OBJECT:
+        case VALUE_PATHSET:
+            // No data, the nesting is updated once the field has been checked
             break;
         default:
-            err.err = NOT_SUPPORTED;
+            err = parse_error(NOT_SUPPORTED, PARSE_REASON_UNSUPPORTED_TYPE);
             break;
     }
 
@@ -381,28 +471,17 @@ err_t read_field_header(parseContext_t *context, field_t *field) {
 
     CHECK(read_next_byte(context, &first_byte));
 
-    if (first_byte >> 4u == 0) {
-        // Type code >= 16
-        uint8_t data_type;
-        CHECK(read_next_byte(context, &data_type));
-        field->data_type = data_type;
-        if (first_byte == 0) {
-            // Field code >= 16
-            CHECK(read_next_byte(context, &field->id));
-        } else {
-            // Field code < 16
-            field->id = first_byte & 0x0fu;
-        }
-    } else {
-        // Type code < 16
-        field->data_type = first_byte >> 4u;
-        if ((first_byte & 0x0fu) == 0) {
-            // Field code >= 16
-            CHECK(read_next_byte(context, &field->id));
-        } else {
-            // Field code < 16
-            field->id = first_byte & 0x0fu;
-        }
+    // A zero nibble means that the type code or the field code is at least 16 and
+    // follows in the next byte, the type code first
+    field->data_type = first_byte >> 4u;
+    field->id = first_byte & 0x0fu;
+
+    if (field->data_type == 0) {
+        CHECK(read_next_byte(context, &field->data_type));
+    }
+
+    if (field->id == 0) {
+        CHECK(read_next_byte(context, &field->id));
     }
 
     return err;
@@ -417,31 +496,34 @@ err_t post_process_field(parseContext_t *context, field_t *field) {
             // Record the transaction type since it must be available for the
             // formatting of certain values
             if (is_transaction_type_field(field)) {
-                context->transaction_type = field->data.u16;
+                context->transaction_type = read_unsigned16(context->data + field->offset);
+                context->transaction_info = get_transaction_info(context->transaction_type);
             }
             break;
         case STI_UINT32:
             // Reject transaction if tfFullyCanonicalSig is not set
             if (field->id == XRP_UINT32_FLAGS) {
-                uint32_t value = field->data.u32;
+                uint32_t value = read_unsigned32(context->data + field->offset);
                 if ((value & TF_FULLY_CANONICAL_SIG) == 0) {
-                    err.err = 0x6800;
+                    err = parse_error(0x6800, PARSE_REASON_NOT_FULLY_CANONICAL);
                     return err;
                 }
             }
 
             break;
         case STI_VL:
-            // Detect when SigningPubKey is empty (needed for multi-sign)
-            if (field->id == XRP_VL_SIGNING_PUB_KEY && field->length == 0) {
-                context->has_empty_pub_key = true;
+            if (field->id == XRP_VL_SIGNING_PUB_KEY) {
+                // Detect when SigningPubKey is empty (needed for multi-sign)
+                if (field->length == 0) {
+                    context->has_empty_pub_key = true;
+                }
             }
             break;
         case STI_ACCOUNT:
             // Safety check to capture the illegal case where an account
             // field is not 20 bytes long.
             if (field->length != XRP_ACCOUNT_SIZE) {
-                err.err = INVALID_STATE;
+                err = parse_error(INVALID_STATE, PARSE_REASON_ACCOUNT_LENGTH);
                 return err;
             }
             break;
@@ -459,61 +541,652 @@ err_t post_process_transaction(parseContext_t *context) {
 
     // Append "empty" regular key field when clearing it
     if (context->transaction_type == TRANSACTION_SET_REGULAR_KEY &&
-        !has_field(context, STI_ACCOUNT, 8)) {
+        !has_field(context, STI_ACCOUNT, XRP_ACCOUNT_REGULAR_KEY)) {
         field_t *field;
         CHECK(append_new_field(context, &field));
         field->data_type = STI_ACCOUNT;
         field->id = XRP_ACCOUNT_REGULAR_KEY;
-        field->data.ptr = NULL;  // Special value to indicate empty regular key
+        field->length = 0;  // Special value to indicate empty regular key
+        set_field_info(field);
     }
 
     return err;
 }
 
+static uint16_t field_order_key(field_t *field) {
+    return field->data_type << 8u | field->id;
+}
+
+static bool is_end_marker(field_t *field) {
+    return (field->data_type == STI_OBJECT && field->id == OBJ_END) ||
+           (field->data_type == STI_ARRAY && field->id == ARR_END);
+}
+
+// Reject duplicated fields and fields that aren't sorted by type and field code, as
+// required by the canonical serialization. This is done once the whole field has
+// been read so that the field can be read again when it continues in the next chunk.
+static err_t check_field_order(parseContext_t *context, field_t *field) {
+    err_t err;
+    err.err = SUCCESS;
+
+    parseFrame_t *frame = current_frame(context);
+    if (frame->array != ARRAY_NONE) {
+        // Arrays only contain objects, whose fields are sorted independently
+        if ((field->data_type != STI_OBJECT || field->id == OBJ_END) && !is_end_marker(field)) {
+            err = parse_error(INVALID_STATE, PARSE_REASON_NOT_AN_OBJECT);
+        }
+        return err;
+    }
+
+    // End markers aren't part of the sorted fields
+    if (is_end_marker(field)) {
+        return err;
+    }
+
+    uint16_t key = field_order_key(field);
+    if (key <= frame->last_field) {
+        err = parse_error(INVALID_STATE, PARSE_REASON_FIELD_ORDER);
+        return err;
+    }
+    frame->last_field = key;
+
+    if (context->depth == 0 && is_tracked_field(field->data_type, field->id)) {
+        context->seen_fields[field->data_type - 1] |= 1u << field->id;
+    }
+
+    return err;
+}
+
+// Reject top level fields that the transaction type doesn't allow. The fields
+// before TransactionType are only checked for canonical order.
+static err_t check_field_schema(parseContext_t *context, field_t *field) {
+    err_t err;
+    err.err = SUCCESS;
+
+    const transactionInfo_t *transaction = context->transaction_info;
+    if (context->depth != 0 || is_end_marker(field) || transaction->optional == SCHEMA_ANY) {
+        return err;
+    }
+
+    uint8_t schema = get_field_info(field)->schema;
+    if (schema == SCHEMA_COMMON) {
+        return err;
+    }
+
+    uint64_t bit = schema < SCHEMA_FIELD_COUNT ? 1ull << schema : 0;
+    if ((bit & (transaction->required | transaction->optional)) == 0) {
+        err = parse_error(FIELD_NOT_ALLOWED, PARSE_REASON_FIELD_NOT_ALLOWED);
+        return err;
+    }
+
+    context->schema_fields |= bit;
+    return err;
+}
+
+static err_t update_nesting(parseContext_t *context, field_t *field, const typeDescriptor_t *type) {
+    err_t err;
+
+    switch (type->kind) {
+        case VALUE_ARRAY:
+            return handle_array_field(context, field);
+        case VALUE_OBJECT:
+            return handle_object_field(context, field);
+        case VALUE_PATHSET:
+            return handle_path_set_field(context);
+        default:
+            err.err = SUCCESS;
+            return err;
+    }
+}
+
 err_t read_field(parseContext_t *context, field_t *field) {
     err_t err;
 
-    if (context->current_array == ARRAY_PATHSET) {
+    if (current_frame(context)->array == ARRAY_PATHSET) {
         CHECK(handle_path_field(context, field));
+        set_field_info(field);
     } else {
         CHECK(read_field_header(context, field));
-        CHECK(read_field_value(context, field));
+        set_field_info(field);
+
+        const typeDescriptor_t *type = get_type_descriptor(field->data_type);
+        CHECK(read_field_value(context, field, type));
+        CHECK(check_field_order(context, field));
+        CHECK(check_field_schema(context, field));
+        CHECK(update_nesting(context, field, type));
+
+        if (!type->post_process) {
+            return err;
+        }
     }
 
     return post_process_field(context, field);
 }
 
-err_t parse_tx_internal(parseContext_t *context) {
+// A single field changes at most the current frame and the depth: a popped frame is
+// left untouched and a pushed frame is above the current one
+typedef struct {
+    uint32_t offset;
+    uint8_t num_fields;
+    uint8_t depth;
+    parseFrame_t frame;
+} parseState_t;
+
+static void save_state(parseContext_t *context, parseState_t *state) {
+    state->offset = context->offset;
+    state->num_fields = context->result.num_fields;
+    state->depth = context->depth;
+    state->frame = *current_frame(context);
+}
+
+static void restore_state(parseContext_t *context, parseState_t *state) {
+    // Clear every field that was appended after the state was saved so that we
+    // don't end up with an unexpected state later on.
+    memset(&context->result.fields[state->num_fields],
+           0,
+           (context->result.num_fields - state->num_fields) * sizeof(field_t));
+
+    context->offset = state->offset;
+    context->result.num_fields = state->num_fields;
+    context->depth = state->depth;
+    *current_frame(context) = state->frame;
+}
+
+#ifdef PARSE_CHECKPOINT_INTERVAL
+#define NO_FIELD 0xFF
+
+// Store the state as a checkpoint, unless more than one array is open. The frames below
+// the one of the state haven't been changed by the field decoded since.
+static void add_checkpoint(parseContext_t *context, parseState_t *state) {
+    parseCheckpoint_t *checkpoint = &context->checkpoints[context->num_checkpoints];
+    checkpoint->array_depth = 0;
+
+    for (uint8_t depth = 1; depth <= state->depth; ++depth) {
+        parseFrame_t *frame = depth == state->depth ? &state->frame : &context->frames[depth];
+        if (frame->array != ARRAY_NONE) {
+            if (checkpoint->array_depth != 0) {
+                return;
+            }
+
+            checkpoint->array_depth = depth;
+            checkpoint->array = frame->array;
+            checkpoint->index1 = frame->index1;
+            checkpoint->index2 = frame->index2;
+        }
+    }
+
+    checkpoint->offset = state->offset;
+    checkpoint->ordinal = context->num_fields;
+    checkpoint->depth = state->depth;
+    context->num_checkpoints++;
+}
+
+// Lazy parsing: count the fields decoded from the last serialized field and discard
+// them. The parser state from before that field is stored as a checkpoint whenever
+// another PARSE_CHECKPOINT_INTERVAL fields have been decoded.
+static err_t record_fields(parseContext_t *context, parseState_t *state) {
     err_t err;
+    uint8_t count = context->result.num_fields;
 
-    context->transaction_type = TRANSACTION_INVALID;
-    context->has_empty_pub_key = false;
+    if (count == 0) {
+        err.err = SUCCESS;
+        return err;
+    }
+
+    if (context->num_fields + count > MAX_FIELD_COUNT) {
+        err = parse_error(NOT_ENOUGH_SPACE, PARSE_REASON_TOO_MANY_FIELDS);
+        return err;
+    }
+
+    if (context->num_fields >= context->num_checkpoints * PARSE_CHECKPOINT_INTERVAL) {
+        add_checkpoint(context, state);
+    }
+
+    for (uint8_t i = 0; i < count; ++i) {
+        field_t *field = &context->result.fields[i];
+        uint8_t priority = get_priority_score(field);
+
+        if (priority < sizeof(context->priority_fields)) {
+            // Sorting duplicated priority fields isn't supported without storing them
+            if (context->priority_fields[priority] != NO_FIELD) {
+                err = parse_error(NOT_SUPPORTED, PARSE_REASON_DUPLICATE_PRIORITY);
+                return err;
+            }
+
+            context->priority_fields[priority] = context->num_fields + i;
+        }
+    }
+
+    context->num_fields += count;
+
+    memset(context->result.fields, 0, count * sizeof(field_t));
+    context->result.num_fields = 0;
+
+    err.err = SUCCESS;
+    return err;
+}
+#endif
+
+err_t parse_next_field(parseContext_t *context) {
+    err_t err;
+
+    // The field is decoded into a scratch record and only stored when it is
+    // visible, so hidden fields never use a slot
+    field_t field;
+    memset(&field, 0, sizeof(field));
+    append_array_info(context, &field);
+
+    uint32_t offset = context->offset;
+    uint8_t index = context->result.num_fields;
+    err = read_field(context, &field);
+
+    if (err.err == SUCCESS) {
+        // Resolve the metadata of the fields appended while decoding the field
+        for (uint8_t i = index; i < context->result.num_fields; ++i) {
+            set_field_info(&context->result.fields[i]);
+        }
+
+        if (!is_field_hidden(context, &field)) {
+            err = insert_field(context, index, &field);
+        }
+    }
+
+    if (err.err != SUCCESS) {
+        return parse_failure(context, err, offset, field.data_type, field.id);
+    }
+
+    return err;
+}
+
+#ifndef PARSE_CHECKPOINT_INTERVAL
+// Fields of a simple XRP Payment in canonical order, see parse_simple_payment
+typedef struct {
+    uint8_t data_type;
+    uint8_t id;
+    uint8_t length;  // Of the value, 0 if it is prefixed by its length
+    bool optional;
+} simpleField_t;
+
+static const simpleField_t simple_payment_fields[] = {
+    {STI_UINT16, XRP_UINT16_TRANSACTION_TYPE, 2, false},
+    {STI_UINT32, XRP_UINT32_FLAGS, 4, false},
+    {STI_UINT32, XRP_UINT32_SEQUENCE, 4, false},
+    {STI_UINT32, XRP_UINT32_DESTINATION_TAG, 4, true},
+    {STI_UINT32, XRP_UINT32_LAST_LEDGER_SEQUENCE, 4, true},
+    {STI_AMOUNT, XRP_UINT64_AMOUNT, XRP_AMOUNT_LEN, false},
+    {STI_AMOUNT, XRP_UINT64_FEE, XRP_AMOUNT_LEN, false},
+    {STI_VL, XRP_VL_SIGNING_PUB_KEY, 0, false},
+    {STI_ACCOUNT, XRP_ACCOUNT_ACCOUNT, 0, false},
+    {STI_ACCOUNT, XRP_ACCOUNT_DESTINATION, 0, false},
+};
+
+#define SIMPLE_PAYMENT_FIELD_COUNT (sizeof(simple_payment_fields) / sizeof(simpleField_t))
+
+// Length of the header at offset if it is the one of the given field, 0 otherwise. The
+// type codes above are below 16, so the header is one byte for field codes below 16,
+// and otherwise the type code followed by the field code in a second byte.
+static uint8_t match_simple_header(parseContext_t *context,
+                                   uint32_t offset,
+                                   const simpleField_t *field) {
+    if (field->id < 16) {
+        if (offset < context->length &&
+            context->data[offset] == (field->data_type << 4u | field->id)) {
+            return 1;
+        }
+    } else if (offset + 1 < context->length && context->data[offset] == field->data_type << 4u &&
+               context->data[offset + 1] == field->id) {
+        return 2;
+    }
+
+    return 0;
+}
+
+// Check a value that the general parser would reject, or decode differently
+static bool is_simple_value(parseContext_t *context, const field_t *field) {
+    const uint8_t *value = context->data + field->offset;
+
+    switch (field->data_type) {
+        case STI_UINT16:
+            return read_unsigned16(value) == TRANSACTION_PAYMENT;
+        case STI_UINT32:
+            return field->id != XRP_UINT32_FLAGS ||
+                   (read_unsigned32(value) & TF_FULLY_CANONICAL_SIG) != 0;
+        case STI_AMOUNT:
+            // XRP amount, issued currencies have a different length
+            return (value[0] >> 7u) == 0;
+        case STI_ACCOUNT:
+            return field->length == XRP_ACCOUNT_SIZE;
+        default:
+            return true;
+    }
+}
+
+bool parse_simple_payment(parseContext_t *context) {
+    field_t fields[SIMPLE_PAYMENT_FIELD_COUNT];
+    uint8_t count = 0;
+    uint32_t offset = context->offset;
+
+    if (offset != 0) {
+        return false;
+    }
+
+    // Find the fields without changing the context, so that nothing has to be undone
+    for (uint8_t i = 0; i < SIMPLE_PAYMENT_FIELD_COUNT; ++i) {
+        const simpleField_t *expected = &simple_payment_fields[i];
+
+        uint8_t header_length = match_simple_header(context, offset, expected);
+        if (header_length == 0) {
+            if (expected->optional) {
+                continue;
+            }
+            return false;
+        }
+        offset += header_length;
+
+        uint16_t length = expected->length;
+        if (length == 0) {
+            // A single length byte, SigningPubKey and accounts are short
+            if (offset >= context->length || context->data[offset] > 192) {
+                return false;
+            }
+            length = context->data[offset++];
+        }
+
+        if (offset + length > context->length) {
+            return false;
+        }
+
+        field_t *field = &fields[count++];
+        memset(field, 0, sizeof(field_t));
+        field->data_type = expected->data_type;
+        field->id = expected->id;
+        field->offset = offset;
+        field->length = length;
+        offset += length;
+
+        if (!is_simple_value(context, field)) {
+            return false;
+        }
+    }
+
+    // Update the context like the general parser does for each field
+    parseFrame_t *frame = current_frame(context);
+    for (uint8_t i = 0; i < count; ++i) {
+        field_t *field = &fields[i];
+        set_field_info(field);
+
+        if (field->data_type == STI_UINT16) {
+            context->transaction_type = TRANSACTION_PAYMENT;
+            context->transaction_info = get_transaction_info(TRANSACTION_PAYMENT);
+        } else if (field->data_type == STI_VL && field->length == 0) {
+            context->has_empty_pub_key = true;
+        }
+
+        frame->last_field = field_order_key(field);
+        context->seen_fields[field->data_type - 1] |= 1u << field->id;
+
+        uint8_t schema = get_field_info(field)->schema;
+        if (schema < SCHEMA_FIELD_COUNT) {
+            context->schema_fields |= 1ull << schema;
+        }
+
+        if (!is_field_hidden(context, field)) {
+            context->result.fields[context->result.num_fields++] = *field;
+        }
+    }
+
+    context->offset = offset;
+    return true;
+}
+#endif
+
+err_t parse_available_fields(parseContext_t *context) {
+    err_t err;
+
+#ifndef PARSE_CHECKPOINT_INTERVAL
+    // Most transactions are simple payments, which are decoded in one go when the
+    // first chunk holds all their fields. The general parser reads what follows.
+    parse_simple_payment(context);
+#endif
 
     while (context->offset != context->length) {
         if (context->offset > context->length) {
-            err.err = EXCEPTION_OVERFLOW;
+            err = parse_error(EXCEPTION_OVERFLOW, PARSE_REASON_TRUNCATED);
             return err;
         }
 
-        field_t *field;
-        CHECK(append_new_field(context, &field));
-        CHECK(read_field(context, field));
+        parseState_t state;
+        save_state(context, &state);
 
-        if (is_field_hidden(field)) {
-            // This must be done after all data has been read since we
-            // always need to keep track of the input stream position.
-            CHECK(remove_last_field(context, field));
+        err = parse_next_field(context);
+        if (err.err == EXCEPTION_OVERFLOW) {
+            // The field continues in a chunk that hasn't been received yet. Rewind
+            // to its first byte and read it again once more data is available.
+            restore_state(context, &state);
+            break;
         }
+
+        if (err.err != SUCCESS) {
+            return err;
+        }
+
+#ifdef PARSE_CHECKPOINT_INTERVAL
+        err = record_fields(context, &state);
+        if (err.err != SUCCESS) {
+            field_t *field = &context->result.fields[0];
+            return parse_failure(context, err, state.offset, field->data_type, field->id);
+        }
+#endif
     }
 
-    CHECK(post_process_transaction(context));
-    sort_fields(&context->result);
+    err.err = SUCCESS;
+    return err;
+}
+
+err_t finish_parsing(parseContext_t *context) {
+    err_t err;
+
+    // All data has been received, so any unread bytes belong to a truncated field,
+    // whose diagnostics were recorded when it was read
+    if (context->offset != context->length) {
+        err = parse_error(EXCEPTION_OVERFLOW, PARSE_REASON_TRUNCATED);
+        return err;
+    }
+
+    // Arrays and objects must be terminated
+    if (context->depth != 0) {
+        err = parse_error(INVALID_STATE, PARSE_REASON_UNTERMINATED);
+        return parse_failure(context, err, context->length, 0, 0);
+    }
+
+    uint64_t missing = context->transaction_info->required & ~context->schema_fields;
+    if (missing != 0) {
+        // Report the first missing field
+        uint8_t schema = 0;
+        while ((missing & (1ULL << schema)) == 0) {
+            schema++;
+        }
+
+        const fieldInfo_t *info = get_schema_field_info(schema);
+        err = parse_error(REQUIRED_FIELD_MISSING, PARSE_REASON_FIELD_MISSING);
+        return parse_failure(context, err, context->length, info->data_type, info->id);
+    }
+
+#ifdef PARSE_CHECKPOINT_INTERVAL
+    parseState_t state;
+    save_state(context, &state);
+
+    err = post_process_transaction(context);
+    if (err.err == SUCCESS) {
+        err = record_fields(context, &state);
+    }
+#else
+    err = post_process_transaction(context);
+    if (err.err == SUCCESS) {
+        sort_fields(&context->result);
+    }
+#endif
+
+    if (err.err != SUCCESS) {
+        return parse_failure(context, err, context->length, 0, 0);
+    }
 
     err.err = SUCCESS;
     return err;
 }
 
-int parse_tx(parseContext_t *context) {
-    err_t err = parse_tx_internal(context);
+void parse_tx_init(parseContext_t *context) {
+    context->transaction_type = TRANSACTION_INVALID;
+    context->transaction_info = get_transaction_info(TRANSACTION_INVALID);
+    context->has_empty_pub_key = false;
+    context->depth = 0;
+    memset(&context->frames[0], 0, sizeof(parseFrame_t));
+    memset(context->seen_fields, 0, sizeof(context->seen_fields));
+    context->schema_fields = 0;
+    memset(&context->error, 0, sizeof(context->error));
+    address_cache_reset(&context->addresses);
+
+#ifdef PARSE_CHECKPOINT_INTERVAL
+    context->num_fields = 0;
+    context->num_checkpoints = 0;
+    memset(context->priority_fields, NO_FIELD, sizeof(context->priority_fields));
+#endif
+}
+
+int parse_tx_update(parseContext_t *context) {
+    err_t err = parse_available_fields(context);
     return err.err;
 }
+
+int parse_tx_finish(parseContext_t *context) {
+    err_t err = finish_parsing(context);
+    return err.err;
+}
+
+int parse_tx(parseContext_t *context) {
+    parse_tx_init(context);
+
+    int err = parse_tx_update(context);
+    if (err != SUCCESS) {
+        return err;
+    }
+
+    return parse_tx_finish(context);
+}
+
+#ifdef PARSE_CHECKPOINT_INTERVAL
+// Convert a display index to the index of the field in parsing order. The priority
+// fields are displayed first and the others keep their order, just like sort_fields.
+static uint8_t get_field_ordinal(parseContext_t *context, uint8_t index) {
+    uint8_t first = context->priority_fields[0];
+    uint8_t second = context->priority_fields[1];
+
+    for (uint8_t i = 0; i < sizeof(context->priority_fields); ++i) {
+        if (context->priority_fields[i] != NO_FIELD) {
+            if (index == 0) {
+                return context->priority_fields[i];
+            }
+            index--;
+        }
+    }
+
+    // Skip the priority fields in ascending order
+    if (first > second) {
+        first = context->priority_fields[1];
+        second = context->priority_fields[0];
+    }
+
+    if (first <= index) {
+        index++;
+    }
+
+    if (second <= index) {
+        index++;
+    }
+
+    return index;
+}
+
+static parseCheckpoint_t *find_checkpoint(parseContext_t *context, uint8_t ordinal) {
+    uint8_t i = ordinal / PARSE_CHECKPOINT_INTERVAL;
+
+    if (i >= context->num_checkpoints) {
+        i = context->num_checkpoints - 1;
+    }
+
+    while (i > 0 && context->checkpoints[i].ordinal > ordinal) {
+        i--;
+    }
+
+    return &context->checkpoints[i];
+}
+
+uint8_t get_field_count(parseContext_t *context) {
+    return context->num_fields;
+}
+
+field_t *get_field(parseContext_t *context, uint8_t index) {
+    uint8_t ordinal = get_field_ordinal(context, index);
+    parseCheckpoint_t *checkpoint = find_checkpoint(context, ordinal);
+
+    // Decoding fields again updates the context, so save what is needed afterwards.
+    // Parsing is complete, so the transaction is the only frame.
+    parseState_t state;
+    save_state(context, &state);
+    uint16_t transaction_type = context->transaction_type;
+    const transactionInfo_t *transaction_info = context->transaction_info;
+    bool has_empty_pub_key = context->has_empty_pub_key;
+
+    // The fields have already been checked to be in canonical order
+    context->offset = checkpoint->offset;
+    context->depth = checkpoint->depth;
+    memset(context->frames, 0, (checkpoint->depth + 1) * sizeof(parseFrame_t));
+    if (checkpoint->array_depth != 0) {
+        parseFrame_t *frame = &context->frames[checkpoint->array_depth];
+        frame->array = checkpoint->array;
+        frame->index1 = checkpoint->index1;
+        frame->index2 = checkpoint->index2;
+    }
+
+    // The fields have already been validated, so the field is always found
+    field_t *field = &context->result.fields[0];
+    uint8_t current = checkpoint->ordinal;
+    while (true) {
+        memset(&context->result, 0, sizeof(context->result));
+
+        bool is_last = context->offset == context->length;
+        err_t err = is_last ? post_process_transaction(context) : parse_next_field(context);
+        if (err.err != SUCCESS) {
+            break;
+        }
+
+        if (ordinal < current + context->result.num_fields) {
+            field = &context->result.fields[ordinal - current];
+            break;
+        }
+
+        if (is_last) {
+            break;
+        }
+
+        current += context->result.num_fields;
+    }
+
+    context->offset = state.offset;
+    context->depth = state.depth;
+    *current_frame(context) = state.frame;
+    context->transaction_type = transaction_type;
+    context->transaction_info = transaction_info;
+    context->has_empty_pub_key = has_empty_pub_key;
+
+    return field;
+}
+#else
+uint8_t get_field_count(parseContext_t *context) {
+    return context->result.num_fields;
+}
+
+field_t *get_field(parseContext_t *context, uint8_t index) {
+    return &context->result.fields[index];
+}
+#endif
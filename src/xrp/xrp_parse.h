@@ -24,25 +24,144 @@
 #include "os.h"
 #include "cx.h"
 #include "fields.h"
+#include "address_cache.h"
 #include "limitations.h"
+#include "transaction_types.h"
+
+#ifdef PARSE_CHECKPOINT_INTERVAL
+// Only the fields decoded from a single serialized field are stored at a time
+#define RESULT_FIELD_COUNT 4
+#else
+#define RESULT_FIELD_COUNT MAX_FIELD_COUNT
+#endif
+
+// Transactions that don't match the schema of their type, reported as 0x68XX
+#define FIELD_NOT_ALLOWED      0x20
+#define REQUIRED_FIELD_MISSING 0x21
 
 typedef struct {
     uint8_t num_fields;
-    field_t fields[MAX_FIELD_COUNT];
+    field_t fields[RESULT_FIELD_COUNT];
 } parseResult_t;
 
+// Why a transaction was rejected, more specific than the status word
+typedef enum {
+    PARSE_REASON_NONE = 0,
+    PARSE_REASON_TRUNCATED,
+    PARSE_REASON_LENGTH_TOO_LARGE,
+    PARSE_REASON_TOO_MANY_FIELDS,
+    PARSE_REASON_UNSUPPORTED_TYPE,
+    PARSE_REASON_TOO_DEEP,
+    PARSE_REASON_TOO_MANY_ITEMS,
+    PARSE_REASON_TOO_MANY_PATHS,
+    PARSE_REASON_TOO_MANY_STEPS,
+    PARSE_REASON_UNEXPECTED_END,
+    PARSE_REASON_NOT_AN_OBJECT,
+    PARSE_REASON_FIELD_ORDER,
+    PARSE_REASON_NOT_FULLY_CANONICAL,
+    PARSE_REASON_ACCOUNT_LENGTH,
+    PARSE_REASON_FIELD_NOT_ALLOWED,
+    PARSE_REASON_FIELD_MISSING,
+    PARSE_REASON_UNTERMINATED,
+    PARSE_REASON_DUPLICATE_PRIORITY,
+} parseReason_t;
+
+// Where parsing failed. The offset is that of the first byte of the offending
+// field, or the end of the transaction when something is missing at the end.
+// The data type and field code are zero when no specific field is to blame.
+typedef struct {
+    uint16_t offset;
+    uint8_t data_type;
+    uint8_t id;
+    uint8_t reason;  // See parseReason_t
+} parseError_t;
+
+// The field counts in limitations.h rely on the size of the compact field_t
+_Static_assert(sizeof(field_t) == 10, "unexpected field_t size");
+
+// An array or object that is being parsed, the transaction itself being the first one
+typedef struct {
+    uint8_t array;        // Array field code or ARRAY_PATHSET, ARRAY_NONE for objects
+    uint8_t index1;       // Current array item or path
+    uint8_t index2;       // Current path step
+    uint16_t last_field;  // Fields of objects must be in canonical order
+} parseFrame_t;
+
+#ifdef PARSE_CHECKPOINT_INTERVAL
+// Parser state before a serialized field. At most one array is open, so that the frames
+// can be restored from that array alone: the others are objects, whose only state is the
+// order of their fields, which has already been checked.
 typedef struct {
+    uint16_t offset;
+    uint8_t ordinal;      // Index of the first field decoded from offset, in parsing order
+    uint8_t depth;
+    uint8_t array_depth;  // Frame of the open array, 0 if there is none
+    uint8_t array;
+    uint8_t index1;
+    uint8_t index2;
+} parseCheckpoint_t;
+
+// The lazy parsing RAM usage in limitations.h relies on the size of the checkpoints
+_Static_assert(sizeof(parseCheckpoint_t) == 8, "unexpected parseCheckpoint_t size");
+#endif
+
+struct parseContext_t {
     uint16_t transaction_type;
+    const transactionInfo_t *transaction_info;
     bool has_empty_pub_key;
     uint8_t *data;
     uint32_t length;
     uint32_t offset;
     parseResult_t result;
-    uint8_t current_array;
-    uint8_t array_index1;
-    uint8_t array_index2;
-} parseContext_t;
+    uint8_t depth;
+    parseFrame_t frames[MAX_NESTING_DEPTH + 1];
+    // Top level fields that have been parsed, by type and then field code
+    uint32_t seen_fields[STI_ACCOUNT];
+    // Transaction specific fields that have been parsed, see schemaField_t
+    uint64_t schema_fields;
+    // Diagnostics of the last error, see parseError_t
+    parseError_t error;
+    // Classic addresses encoded while reviewing this transaction
+    addressCache_t addresses;
+#ifdef PARSE_CHECKPOINT_INTERVAL
+    uint8_t num_fields;
+    uint8_t num_checkpoints;
+    parseCheckpoint_t checkpoints[MAX_CHECKPOINT_COUNT];
+    // Ordinals of the TransactionType and Account fields, which are displayed first
+    uint8_t priority_fields[2];
+#endif
+};
 
+// Parse a complete transaction in one go
 int parse_tx(parseContext_t *parse_context);
 
+// Incremental parsing: call parse_tx_init once, then parse_tx_update every time
+// more data has been appended to the buffer (by increasing length), and finally
+// parse_tx_finish once the last chunk has been received. A field that is split
+// across chunks is read again from its first byte when the next chunk arrives,
+// while malformed fields are rejected as soon as they are complete.
+void parse_tx_init(parseContext_t *parse_context);
+int parse_tx_update(parseContext_t *parse_context);
+int parse_tx_finish(parseContext_t *parse_context);
+
+#ifndef PARSE_CHECKPOINT_INTERVAL
+// Decode a simple XRP Payment (TransactionType, Flags, Sequence, DestinationTag,
+// LastLedgerSequence, Amount, Fee, SigningPubKey, Account and Destination) at the
+// start of the transaction, with the same result as the general parser. The field
+// headers are matched byte for byte, LastLedgerSequence having a two byte header as its
+// field code is above 15. Returns false without changing the context if the data
+// doesn't start with such fields, which parse_tx_update tries before reading the first
+// field.
+bool parse_simple_payment(parseContext_t *parse_context);
+#endif
+
+// Whether a top level field has been parsed. Only the types up to STI_ACCOUNT and
+// field codes below 32 are tracked.
+bool has_field(parseContext_t *parse_context, field_type_t data_type, uint8_t id);
+
+// Access to the parsed fields in display order. With lazy parsing the returned field
+// is decoded again and stays valid until the next call to get_field.
+uint8_t get_field_count(parseContext_t *parse_context);
+field_t *get_field(parseContext_t *parse_context, uint8_t index);
+
 #endif  // LEDGER_APP_XRP_XRPPARSE_H
@@ -13,7 +13,7 @@ from ragger.navigator import Navigator
 from ragger.navigator.navigation_scenario import NavigateWithScenario
 from ragger.bip import calculate_public_key_and_chaincode, CurveChoice
 from ragger.error import ExceptionRAPDU
-from .xrp import XRPClient, Errors
+from .xrp import XRPClient, Errors, Ins, P1, ParseReason
 from .utils import DEFAULT_PATH, DEFAULT_BIP32_PATH
 from .utils import verify_ecdsa_secp256k1, verify_version
 
@@ -41,11 +41,16 @@ def test_sign_too_large(backend: BackendInterface, firmware: Firmware, navigator
 def test_sign_invalid_tx(backend: BackendInterface, firmware: Firmware, navigator: Navigator):
     xrp = XRPClient(backend, firmware, navigator)
     payload = DEFAULT_BIP32_PATH + b"a" * (40)
-    try:
-        backend.raise_policy = RaisePolicy.RAISE_ALL_BUT_0x9000
-        xrp.sign(payload)
-    except ExceptionRAPDU as rapdu:
-        assert rapdu.status in [Errors.SW_INTERNAL_1, Errors.SW_INTERNAL_2]
+    backend.raise_policy = RaisePolicy.RAISE_ALL_BUT_0x9000
+    with pytest.raises(ExceptionRAPDU) as err:
+        with xrp.sign(payload):
+            pass
+
+    # The second Amount field (0x61) breaks the canonical field order
+    assert err.value.status == Errors.SW_INTERNAL_4
+    offset, data_type, field_id, reason = xrp.get_parse_error(err.value.data)
+    assert (offset, data_type, field_id) == (9, 6, 1)
+    assert reason == ParseReason.FIELD_ORDER
 
 
 def test_path_too_long(backend: BackendInterface, firmware: Firmware, navigator: Navigator):
@@ -122,6 +127,48 @@ def test_sign_reject(backend: BackendInterface,
     assert len(err.value.data) == 0
 
 
+# pragma pylint: disable=line-too-long
+# Transaction extracted from testcases/01-payment/01-basic.raw
+BASIC_PAYMENT = "120000228000000024000000036140000000000F424068400000000000000F732102B79DA34F4551CA976B66AA78A55C43707EC2BB2BEC39F95BD53F24E2E45A9E6781140511E17DB83BB6F113939D67BC8EA539EDC926FC83140511E17DB83BB6F113939D67BC8EA539EDC926FC"
+# pragma pylint: enable=line-too-long
+
+
+def test_parse_tx(backend: BackendInterface, firmware: Firmware, navigator: Navigator):
+    xrp = XRPClient(backend, firmware, navigator)
+
+    transaction_type, field_count, screen_count, fields = \
+        xrp.parse(DEFAULT_BIP32_PATH + bytes.fromhex(BASIC_PAYMENT))
+    assert transaction_type == 0
+    assert field_count == 5
+    # One screen per field, then sign and reject on Nano. The introduction, a page of
+    # fields and the sign page elsewhere.
+    assert screen_count == (7 if firmware.device.startswith("nano") else 3)
+
+    # Transaction Type, Account, Amount, Fee and Destination, in display order
+    assert fields == [(1, 2, 1, 2), (8, 1, 68, 20), (6, 1, 14, 8), (6, 8, 23, 8), (8, 3, 90, 20)]
+
+
+@pytest.mark.parametrize("first_ins,next_ins", [(Ins.PARSE, Ins.SIGN), (Ins.SIGN, Ins.PARSE)])
+def test_upload_mixed_ins(backend: BackendInterface,
+                          firmware: Firmware,
+                          navigator: Navigator,
+                          first_ins: Ins,
+                          next_ins: Ins):
+    xrp = XRPClient(backend, firmware, navigator)
+    payload = DEFAULT_BIP32_PATH + bytes.fromhex(BASIC_PAYMENT)
+    backend.raise_policy = RaisePolicy.RAISE_ALL_BUT_0x9000
+
+    # The upload started with one instruction can't be continued with the other
+    xrp.send_chunk(first_ins, P1.FIRST, payload[:64])
+    with pytest.raises(ExceptionRAPDU) as err:
+        xrp.send_chunk(next_ins, P1.LAST, payload[64:])
+    assert err.value.status == Errors.SW_INVALID_PATH
+
+    # The transaction context has been wiped, a new upload starts from scratch
+    transaction_type, field_count, _, _ = xrp.parse(payload)
+    assert (transaction_type, field_count) == (0, 5)
+
+
 def test_sign_valid_tx(backend: BackendInterface,
                        firmware: Firmware,
                        navigator: Navigator,
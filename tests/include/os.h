@@ -25,5 +25,7 @@
 
 #define PRINTF(...)
 
+#define PIC(x) (x)
+
 #define MAX(a, b) ((a) > (b)) ? (a) : (b)
 #define MIN(a, b) ((a) < (b)) ? (a) : (b)
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "cx.h"
+
+// Digit by digit base58 encoder the app used before switching to base 58^2 limbs, kept as the
+// reference the new encoder is checked against. divisions counts the modulo and division pairs.
+static inline size_t reference_encode_base58(const uint8_t *in,
+                                             size_t length,
+                                             char *out,
+                                             unsigned long *divisions) {
+    static const char alphabet[] = "rpshnaf39wBUDNEGHJKLM4PQRST7VWXYZ2bcdeCg65jkm8oFqi1tuvAxyz";
+    unsigned char buffer[26 * 138 / 100 + 1] = {0};
+    size_t i, j, start_at, stop_at;
+    size_t zero_count = 0;
+    size_t output_size;
+
+    while ((zero_count < length) && (in[zero_count] == 0)) {
+        ++zero_count;
+    }
+
+    output_size = (length - zero_count) * 138 / 100 + 1;
+    stop_at = output_size - 1;
+    for (start_at = zero_count; start_at < length; start_at++) {
+        int carry = in[start_at];
+        for (j = output_size - 1; (int) j >= 0; j--) {
+            carry += 256 * buffer[j];
+            buffer[j] = carry % 58;
+            carry /= 58;
+            if (divisions != NULL) {
+                *divisions += 1;
+            }
+
+            if (j <= stop_at - 1 && carry == 0) {
+                break;
+            }
+        }
+        stop_at = j;
+    }
+
+    j = 0;
+    while (j < output_size && buffer[j] == 0) {
+        j += 1;
+    }
+
+    memset(out, alphabet[0], zero_count);
+
+    i = zero_count;
+    while (j < output_size) {
+        out[i++] = alphabet[buffer[j++]];
+    }
+
+    return i;
+}
+
+// Version, account and checksum, as built by xrp_public_key_to_encoded_base58
+static inline size_t reference_account_payload(const uint8_t account[20],
+                                               uint16_t version,
+                                               uint8_t *payload) {
+    uint8_t checksum[32];
+    cx_sha256_t hash;
+    size_t version_size = version > 255 ? 2 : 1;
+
+    if (version > 255) {
+        payload[0] = version >> 8u;
+        payload[1] = version;
+    } else {
+        payload[0] = version;
+    }
+    memcpy(payload + version_size, account, 20);
+
+    cx_sha256_init(&hash);
+    cx_hash_no_throw(&hash.header, CX_LAST, payload, 20 + version_size, checksum, 32);
+    cx_sha256_init(&hash);
+    cx_hash_no_throw(&hash.header, CX_LAST, checksum, 32, checksum, 32);
+    memcpy(payload + 20 + version_size, checksum, 4);
+
+    return 24 + version_size;
+}
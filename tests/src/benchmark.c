@@ -0,0 +1,949 @@
+#include <dirent.h>
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include <openssl/evp.h>
+
+#include "cx.h"
+#include "../src/xrp/xrp_parse.h"
+#include "../src/xrp/fmt.h"
+#include "../src/xrp/field_sort.h"
+#include "../src/xrp/field_info.h"
+#include "../src/xrp/format_cache.h"
+#include "../src/xrp/xrp_helpers.h"
+#include "../src/xrp/time.h"
+#include "../src/xrp/text_writer.h"
+#include "../src/xrp/ascii_strings.h"
+#include "../src/xrp/flags.h"
+#include "../src/xrp/transaction_types.h"
+#include "../src/xrp/readers.h"
+#include "base58_reference.h"
+#include "flags_reference.h"
+#include "time_reference.h"
+#include "swar_reference.h"
+
+// Host benchmarks, run with ./benchmark from the build directory. The
+// results are only meaningful relative to each other.
+
+#define APDU_CHUNK_SIZE 255
+
+parseContext_t parse_context;
+
+static double now(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+// Time spent hashing the transaction once the user has approved it, when the whole
+// transaction is hashed at once versus when it has been hashed during reception and
+// only the 20 bytes multi-sign suffix remain.
+static void bench_transaction_hash(void) {
+    static const size_t sizes[] = {100, 250, 500, 800, 1000, 2500, 5000, 10000};
+    static uint8_t data[10000 + 20];
+    uint8_t digest[64];
+    unsigned int digest_length;
+    const int iterations = 20000;
+
+    EVP_MD_CTX *ctx = EVP_MD_CTX_new();
+    EVP_MD_CTX *received = EVP_MD_CTX_new();
+    memset(data, 0xa5, sizeof(data));
+
+    printf("SHA-512 after approval (us per transaction)\n");
+    printf("%8s %12s %12s\n", "size", "full", "streaming");
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        size_t size = sizes[i];
+
+        double start = now();
+        for (int j = 0; j < iterations; j++) {
+            EVP_DigestInit_ex(ctx, EVP_sha512(), NULL);
+            EVP_DigestUpdate(ctx, data, size + 20);
+            EVP_DigestFinal_ex(ctx, digest, &digest_length);
+        }
+        double full = now() - start;
+
+        // Hashed chunk by chunk while the APDUs are received
+        EVP_DigestInit_ex(received, EVP_sha512(), NULL);
+        for (size_t offset = 0; offset < size; offset += APDU_CHUNK_SIZE) {
+            EVP_DigestUpdate(received, data + offset, MIN(size - offset, APDU_CHUNK_SIZE));
+        }
+
+        start = now();
+        for (int j = 0; j < iterations; j++) {
+            EVP_MD_CTX_copy_ex(ctx, received);
+            EVP_DigestUpdate(ctx, data + size, 20);
+            EVP_DigestFinal_ex(ctx, digest, &digest_length);
+        }
+        double streaming = now() - start;
+
+        printf("%8zu %12.2f %12.2f\n",
+               size,
+               full * 1e6 / iterations,
+               streaming * 1e6 / iterations);
+    }
+    printf("\n");
+
+    EVP_MD_CTX_free(received);
+    EVP_MD_CTX_free(ctx);
+}
+
+static uint8_t *load_transaction_data(const char *filename, size_t *size) {
+    FILE *f = fopen(filename, "rb");
+    if (f == NULL) {
+        fprintf(stderr, "cannot open %s\n", filename);
+        exit(1);
+    }
+
+    fseek(f, 0, SEEK_END);
+    long filesize = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    uint8_t *data = malloc(filesize);
+    if (data == NULL || fread(data, 1, filesize, f) != (size_t) filesize) {
+        exit(1);
+    }
+    *size = filesize;
+    fclose(f);
+
+    return data;
+}
+
+// Time needed to parse a transaction and to decode and format a field when a
+// screen is displayed, in display order and backwards. With lazy parsing
+// (PARSE_CHECKPOINT_INTERVAL) the fields are decoded again from a checkpoint.
+static void bench_field_access(void) {
+    static const char *testcases[] = {
+        "../testcases/01-payment/01-basic.raw",
+        "../testcases/01-payment/11-issued-currency-paths.raw",
+        "../testcases/01-payment/16-memos.raw",
+        "../testcases/18-arrays/02-multiple.raw",
+    };
+    const int iterations = 20000;
+    field_value_t value;
+
+#ifdef PARSE_CHECKPOINT_INTERVAL
+    printf("Field access, lazy parsing with PARSE_CHECKPOINT_INTERVAL=%d\n",
+           PARSE_CHECKPOINT_INTERVAL);
+#else
+    printf("Field access, all fields stored\n");
+#endif
+    printf("sizeof(parseContext_t) = %zu bytes\n", sizeof(parseContext_t));
+    printf("%-28s %6s %12s %12s %12s\n", "testcase", "fields", "parse", "forward", "backward");
+    for (size_t i = 0; i < sizeof(testcases) / sizeof(testcases[0]); i++) {
+        size_t size;
+        uint8_t *data = load_transaction_data(testcases[i], &size);
+
+        double start = now();
+        for (int j = 0; j < iterations; j++) {
+            memset(&parse_context, 0, sizeof(parse_context));
+            parse_context.data = data;
+            parse_context.length = size;
+            parse_tx(&parse_context);
+        }
+        double parse = now() - start;
+
+        uint8_t count = get_field_count(&parse_context);
+
+        start = now();
+        for (int j = 0; j < iterations; j++) {
+            for (uint8_t k = 0; k < count; k++) {
+                format_field(&parse_context, get_field(&parse_context, k), &value);
+            }
+        }
+        double forward = now() - start;
+
+        start = now();
+        for (int j = 0; j < iterations; j++) {
+            for (uint8_t k = count; k > 0; k--) {
+                format_field(&parse_context, get_field(&parse_context, k - 1), &value);
+            }
+        }
+        double backward = now() - start;
+
+        printf("%-28s %6u %12.2f %12.2f %12.2f\n",
+               strrchr(testcases[i], '/') + 1,
+               count,
+               parse * 1e6 / iterations,
+               forward * 1e6 / iterations / count,
+               backward * 1e6 / iterations / count);
+        free(data);
+    }
+    printf("(parse in us per transaction, access in us per screen)\n\n");
+}
+
+#define MAX_TESTCASES 256
+
+typedef struct {
+    char name[128];
+    uint8_t *data;
+    size_t size;
+} testcase_t;
+
+static testcase_t all_testcases[MAX_TESTCASES];
+static int testcase_count;
+
+// Load every tests/testcases/*/*.raw file
+static void load_all_testcases(void) {
+    struct dirent **categories;
+
+    int category_count = scandir("../testcases", &categories, NULL, alphasort);
+    for (int i = 0; i < category_count; i++) {
+        char directory[512];
+        struct dirent **files;
+        snprintf(directory, sizeof(directory), "../testcases/%s", categories[i]->d_name);
+
+        int file_count = -1;
+        if (categories[i]->d_name[0] != '.') {
+            file_count = scandir(directory, &files, NULL, alphasort);
+        }
+        for (int j = 0; j < file_count; j++) {
+            const char *name = files[j]->d_name;
+            size_t length = strlen(name);
+            if (length >= 4 && strcmp(name + length - 4, ".raw") == 0 &&
+                testcase_count < MAX_TESTCASES) {
+                char path[1024];
+                testcase_t *testcase = &all_testcases[testcase_count++];
+                snprintf(path, sizeof(path), "%s/%s", directory, name);
+                snprintf(testcase->name,
+                         sizeof(testcase->name),
+                         "%s/%s",
+                         categories[i]->d_name,
+                         name);
+                testcase->data = load_transaction_data(path, &testcase->size);
+            }
+            free(files[j]);
+        }
+
+        if (file_count >= 0) {
+            free(files);
+        }
+        free(categories[i]);
+    }
+
+    if (category_count >= 0) {
+        free(categories);
+    }
+}
+
+// Number of hidden fields of each testcase. They used to be stored in a field slot
+// that was cleared right after it was decoded, which now only happens for the
+// visible fields. The data is given to the parser one byte at a time, so that every
+// update reads at most one field.
+static void bench_hidden_fields(void) {
+    int total_read = 0;
+    int total_hidden = 0;
+
+    printf("Slot churn of hidden fields\n");
+    printf("%-56s %6s %6s %6s\n", "testcase", "read", "hidden", "stored");
+
+    for (int i = 0; i < testcase_count; i++) {
+        testcase_t *testcase = &all_testcases[i];
+        int read = 0;
+        int hidden = 0;
+
+        memset(&parse_context, 0, sizeof(parse_context));
+        parse_context.data = testcase->data;
+        parse_tx_init(&parse_context);
+        while (parse_context.length < testcase->size) {
+            uint32_t offset = parse_context.offset;
+            uint8_t count = get_field_count(&parse_context);
+
+            parse_context.length++;
+            if (parse_tx_update(&parse_context) != 0) {
+                break;
+            }
+
+            if (parse_context.offset != offset) {
+                read++;
+                hidden += get_field_count(&parse_context) == count;
+            }
+        }
+
+        if (parse_context.length == testcase->size && parse_tx_finish(&parse_context) == 0) {
+            printf("%-56s %6d %6d %6u\n",
+                   testcase->name,
+                   read,
+                   hidden,
+                   get_field_count(&parse_context));
+            total_read += read;
+            total_hidden += hidden;
+        }
+    }
+
+    printf("%-56s %6d %6d\n\n", "total", total_read, total_hidden);
+}
+
+// Parser throughput over all the testcases that can be parsed
+static void bench_parse_throughput(void) {
+    const int iterations = 500;
+    size_t total_size = 0;
+
+    for (int i = 0; i < testcase_count; i++) {
+        memset(&parse_context, 0, sizeof(parse_context));
+        parse_context.data = all_testcases[i].data;
+        parse_context.length = all_testcases[i].size;
+        if (parse_tx(&parse_context) == 0) {
+            total_size += all_testcases[i].size;
+        }
+    }
+
+    // Best of several rounds, to reduce the noise of other processes
+    double elapsed = 0;
+    for (int round = 0; round < 10; round++) {
+        double start = now();
+        for (int j = 0; j < iterations; j++) {
+            for (int i = 0; i < testcase_count; i++) {
+                memset(&parse_context, 0, sizeof(parse_context));
+                parse_context.data = all_testcases[i].data;
+                parse_context.length = all_testcases[i].size;
+                parse_tx(&parse_context);
+            }
+        }
+        double round_elapsed = now() - start;
+        if (round == 0 || round_elapsed < elapsed) {
+            elapsed = round_elapsed;
+        }
+    }
+
+    printf("Parse throughput\n");
+    printf("%d testcases, %zu bytes: %.1f MB/s\n\n",
+           testcase_count,
+           total_size,
+           total_size * (double) iterations / elapsed / 1e6);
+}
+
+#ifndef PARSE_CHECKPOINT_INTERVAL
+// Previous implementation of sort_fields, which restarts one step back after every swap
+static void restart_sort_fields(parseResult_t *result) {
+    for (uint8_t i = 0; i < result->num_fields - 1; ++i) {
+        field_t *cur_field = &result->fields[i];
+        field_t *next_field = &result->fields[i + 1];
+
+        if (get_priority_score(next_field) < get_priority_score(cur_field)) {
+            field_t buffer_field;
+            memcpy(&buffer_field, &result->fields[i], sizeof(field_t));
+            memcpy(&result->fields[i], &result->fields[i + 1], sizeof(field_t));
+            memcpy(&result->fields[i + 1], &buffer_field, sizeof(field_t));
+            i = MAX(0, i - 1) - 1;
+        }
+    }
+}
+
+// Account and TransactionType are usually serialized after most other fields, which
+// is the worst case for the previous sort
+static void fill_sort_fields(parseResult_t *result, int count) {
+    memset(result, 0, sizeof(*result));
+    result->num_fields = count;
+    for (int i = 0; i < count; i++) {
+        field_t *field = &result->fields[i];
+        if (i == count - 1) {
+            field->data_type = STI_UINT16;
+            field->id = XRP_UINT16_TRANSACTION_TYPE;
+        } else if (i >= count - 1 - count / 4) {
+            field->data_type = STI_ACCOUNT;
+            field->id = XRP_ACCOUNT_ACCOUNT;
+        } else {
+            field->data_type = STI_UINT32;
+            field->id = XRP_UINT32_FLAGS;
+        }
+        set_field_info(field);
+    }
+}
+
+static void bench_sort_fields(void) {
+    static parseResult_t result;
+    const int iterations = 20000;
+
+    printf("Field sort (us per transaction)\n");
+    printf("%8s %12s %12s\n", "fields", "restart", "counting");
+    for (int count = 8; count < MAX_FIELD_COUNT * 2; count *= 2) {
+        if (count > MAX_FIELD_COUNT) {
+            count = MAX_FIELD_COUNT;
+        }
+
+        double start = now();
+        for (int j = 0; j < iterations; j++) {
+            fill_sort_fields(&result, count);
+            restart_sort_fields(&result);
+        }
+        double restart = now() - start;
+
+        start = now();
+        for (int j = 0; j < iterations; j++) {
+            fill_sort_fields(&result, count);
+            sort_fields(&result);
+        }
+        double counting = now() - start;
+
+        printf("%8d %12.2f %12.2f\n",
+               count,
+               restart * 1e6 / iterations,
+               counting * 1e6 / iterations);
+    }
+    printf("\n");
+}
+#endif
+
+// Hit rate of the formatted field cache over all the testcases, for a BAGL review
+// that goes to the last field, back to the first one and forward again, and for NBGL
+// pages of 5 fields whose pairs are requested for the layout and for the display
+static void bench_format_cache(void) {
+    static formatCache_t cache;
+    unsigned int bagl_hits = 0, bagl_misses = 0;
+    unsigned int nbgl_hits = 0, nbgl_misses = 0;
+
+    for (int i = 0; i < testcase_count; i++) {
+        memset(&parse_context, 0, sizeof(parse_context));
+        parse_context.data = all_testcases[i].data;
+        parse_context.length = all_testcases[i].size;
+        if (parse_tx(&parse_context) != 0) {
+            continue;
+        }
+        int count = get_field_count(&parse_context);
+
+        format_cache_reset(&cache);
+        for (int k = 0; k < count; k++) {
+            get_formatted_field(&cache, &parse_context, k, 0);
+        }
+        for (int k = count - 1; k >= 0; k--) {
+            get_formatted_field(&cache, &parse_context, k, 0);
+        }
+        for (int k = 0; k < count; k++) {
+            get_formatted_field(&cache, &parse_context, k, 0);
+        }
+        bagl_hits += cache.hits;
+        bagl_misses += cache.misses;
+
+        format_cache_reset(&cache);
+        for (int page = 0; page < count; page += 5) {
+            int end = MIN(page + 5, count);
+            for (int pass = 0; pass < 2; pass++) {
+                for (int k = page; k < end; k++) {
+                    get_formatted_field(&cache, &parse_context, k, 0);
+                }
+            }
+        }
+        nbgl_hits += cache.hits;
+        nbgl_misses += cache.misses;
+    }
+
+    printf("Format cache with FORMAT_CACHE_SIZE=%d\n", FORMAT_CACHE_SIZE);
+    printf("%-8s %8s %8s %8s\n", "flow", "hits", "misses", "rate");
+    printf("%-8s %8u %8u %7.1f%%\n",
+           "BAGL",
+           bagl_hits,
+           bagl_misses,
+           100.0 * bagl_hits / (bagl_hits + bagl_misses));
+    printf("%-8s %8u %8u %7.1f%%\n\n",
+           "NBGL",
+           nbgl_hits,
+           nbgl_misses,
+           100.0 * nbgl_hits / (nbgl_hits + nbgl_misses));
+}
+
+#ifndef PARSE_CHECKPOINT_INTERVAL
+// Parse the transaction with the general parser only, by sending the TransactionType
+// field as a separate first chunk, which is too short for the simple payment fast path
+static void parse_tx_general(parseContext_t *context) {
+    size_t size = context->length;
+
+    parse_tx_init(context);
+    context->length = 3;
+    parse_tx_update(context);
+    context->length = size;
+    parse_tx_update(context);
+    parse_tx_finish(context);
+}
+
+// Time needed to parse the simple payments among the testcases, with and without the
+// fast path (best of several rounds)
+static void bench_simple_payment(void) {
+    const int iterations = 20000;
+
+    printf("Simple payment fast path (ns per transaction)\n");
+    printf("%-56s %10s %10s\n", "testcase", "general", "fast");
+    for (int i = 0; i < testcase_count; i++) {
+        testcase_t *testcase = &all_testcases[i];
+
+        memset(&parse_context, 0, sizeof(parse_context));
+        parse_context.data = testcase->data;
+        parse_context.length = testcase->size;
+        parse_tx_init(&parse_context);
+        if (!parse_simple_payment(&parse_context)) {
+            continue;
+        }
+
+        double general = 0;
+        double fast = 0;
+        for (int round = 0; round < 5; round++) {
+            double start = now();
+            for (int j = 0; j < iterations; j++) {
+                memset(&parse_context, 0, sizeof(parse_context));
+                parse_context.data = testcase->data;
+                parse_context.length = testcase->size;
+                parse_tx_general(&parse_context);
+            }
+            double elapsed = now() - start;
+            if (round == 0 || elapsed < general) {
+                general = elapsed;
+            }
+
+            start = now();
+            for (int j = 0; j < iterations; j++) {
+                memset(&parse_context, 0, sizeof(parse_context));
+                parse_context.data = testcase->data;
+                parse_context.length = testcase->size;
+                parse_tx(&parse_context);
+            }
+            elapsed = now() - start;
+            if (round == 0 || elapsed < fast) {
+                fast = elapsed;
+            }
+        }
+
+        printf("%-56s %10.1f %10.1f\n",
+               testcase->name,
+               general * 1e9 / iterations,
+               fast * 1e9 / iterations);
+    }
+    printf("\n");
+}
+#endif
+
+// Classic address encoding, digit by digit versus base 58^2 limbs. Both include the two
+// SHA-256 of the checksum, which is timed on its own so that the encoders can be compared.
+// Cortex-M0 has no divide instruction, every division is a call to the runtime helper, so the
+// division and multiplication counts are reported as a proxy for the cost on device, with the
+// remainders counted as one multiplication each.
+static void bench_base58(void) {
+    enum { ADDRESS_COUNT = 256 };
+    static xrp_account_t accounts[ADDRESS_COUNT];
+    static uint8_t payloads[ADDRESS_COUNT][26];
+    char encoded[64];
+    xrp_address_t address;
+    const int iterations = 200;
+    unsigned long divisions = 0;
+    unsigned long multiplications = 0;
+
+    srand(58);
+    for (int i = 0; i < ADDRESS_COUNT; i++) {
+        for (size_t j = 0; j < sizeof(accounts[i].buf); j++) {
+            accounts[i].buf[j] = rand();
+        }
+
+        size_t length = reference_account_payload(accounts[i].buf, 0, payloads[i]);
+        reference_encode_base58(payloads[i], length, encoded, &divisions);
+        for (size_t j = 1; j < length; j++) {
+            size_t limb_count = (length - 1 - j) * 8 / 11 + 1;
+            multiplications += limb_count < 18 ? limb_count : 18;
+        }
+    }
+
+    double timings[3] = {0};
+    for (int round = 0; round < 5; round++) {
+        double elapsed[3];
+
+        double start = now();
+        for (int j = 0; j < iterations; j++) {
+            for (int i = 0; i < ADDRESS_COUNT; i++) {
+                reference_account_payload(accounts[i].buf, 0, payloads[i]);
+            }
+        }
+        elapsed[0] = now() - start;
+
+        start = now();
+        for (int j = 0; j < iterations; j++) {
+            for (int i = 0; i < ADDRESS_COUNT; i++) {
+                size_t length = reference_account_payload(accounts[i].buf, 0, payloads[i]);
+                reference_encode_base58(payloads[i], length, encoded, NULL);
+            }
+        }
+        elapsed[1] = now() - start;
+
+        start = now();
+        for (int j = 0; j < iterations; j++) {
+            for (int i = 0; i < ADDRESS_COUNT; i++) {
+                xrp_public_key_to_encoded_base58(NULL, &accounts[i], &address, 0);
+            }
+        }
+        elapsed[2] = now() - start;
+
+        for (int k = 0; k < 3; k++) {
+            if (round == 0 || elapsed[k] < timings[k]) {
+                timings[k] = elapsed[k];
+            }
+        }
+    }
+
+    double scale = 1e9 / (iterations * ADDRESS_COUNT);
+    printf("Base58 address encoding (ns per address, checksum excluded)\n");
+    printf("%-12s %10s %10s %10s\n", "encoder", "time", "divisions", "multiplies");
+    printf("%-12s %10.1f %10.1f %10.1f\n",
+           "digits",
+           (timings[1] - timings[0]) * scale,
+           (double) divisions / ADDRESS_COUNT,
+           (double) divisions / ADDRESS_COUNT);
+    printf("%-12s %10.1f %10d %10.1f\n",
+           "limbs",
+           (timings[2] - timings[0]) * scale,
+           18,
+           (double) multiplications / ADDRESS_COUNT + 3 * 18);
+    printf("\n");
+}
+
+// Expiration, CancelAfter and FinishAfter formatting, the musl port working on long long
+// and snprintf versus the 32-bit conversion. The times are spread over the whole range.
+static void bench_time(void) {
+    enum { TIME_COUNT = 1024 };
+    static uint8_t data[TIME_COUNT * 4];
+    field_t field = {.length = 4, .data_type = STI_UINT32, .id = XRP_UINT32_EXPIRATION};
+    field_value_t value;
+    textWriter_t out;
+    const int iterations = 500;
+
+    srand(2000);
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = rand();
+    }
+    parse_context.data = data;
+    parse_context.length = sizeof(data);
+
+    double timings[2] = {0};
+    for (int round = 0; round < 5; round++) {
+        double elapsed[2];
+
+        double start = now();
+        for (int j = 0; j < iterations; j++) {
+            for (int i = 0; i < TIME_COUNT; i++) {
+                uint32_t t = (uint32_t) data[4 * i] << 24 | data[4 * i + 1] << 16 |
+                             data[4 * i + 2] << 8 | data[4 * i + 3];
+                reference_format_time(t, value.buf, sizeof(value.buf));
+            }
+        }
+        elapsed[0] = now() - start;
+
+        start = now();
+        for (int j = 0; j < iterations; j++) {
+            for (int i = 0; i < TIME_COUNT; i++) {
+                field.offset = 4 * i;
+                writer_init(&out, value.buf, sizeof(value.buf));
+                format_time(&parse_context, &field, &out);
+            }
+        }
+        elapsed[1] = now() - start;
+
+        for (int k = 0; k < 2; k++) {
+            if (round == 0 || elapsed[k] < timings[k]) {
+                timings[k] = elapsed[k];
+            }
+        }
+    }
+
+    double scale = 1e9 / (iterations * TIME_COUNT);
+    printf("Time formatting (ns per field)\n");
+    printf("%-12s %10s\n", "conversion", "time");
+    printf("%-12s %10.1f\n", "64-bit", timings[0] * scale);
+    printf("%-12s %10.1f\n", "32-bit", timings[1] * scale);
+    printf("\n");
+}
+
+// Integers and array indices written by the field formatters, with snprintf versus
+// text_writer.h
+static void bench_print(void) {
+    enum { VALUE_COUNT = 1024 };
+    static uint32_t values[VALUE_COUNT];
+    static volatile size_t sink;
+    char buf[64];
+    textWriter_t out;
+    const int iterations = 1000;
+
+    srand(10);
+    for (int i = 0; i < VALUE_COUNT; i++) {
+        values[i] = (uint32_t) rand() >> (i % 31);
+    }
+
+    double timings[6] = {0};
+    for (int round = 0; round < 5; round++) {
+        double elapsed[6];
+        double start;
+
+        start = now();
+        for (int j = 0; j < iterations; j++) {
+            for (int i = 0; i < VALUE_COUNT; i++) {
+                sink = snprintf(buf, sizeof(buf), "%u", values[i]);
+            }
+        }
+        elapsed[0] = now() - start;
+
+        start = now();
+        for (int j = 0; j < iterations; j++) {
+            for (int i = 0; i < VALUE_COUNT; i++) {
+                writer_init(&out, buf, sizeof(buf));
+                write_uint(&out, values[i]);
+                sink = out.length;
+            }
+        }
+        elapsed[1] = now() - start;
+
+        start = now();
+        for (int j = 0; j < iterations; j++) {
+            for (int i = 0; i < VALUE_COUNT; i++) {
+                sink = snprintf(buf, sizeof(buf), "%u.%07u", values[i] >> 8, values[i] % 10000000);
+            }
+        }
+        elapsed[2] = now() - start;
+
+        start = now();
+        for (int j = 0; j < iterations; j++) {
+            for (int i = 0; i < VALUE_COUNT; i++) {
+                writer_init(&out, buf, sizeof(buf));
+                write_uint(&out, values[i] >> 8);
+                write_char(&out, '.');
+                write_uint_padded(&out, values[i] % 10000000, 7);
+                sink = out.length;
+            }
+        }
+        elapsed[3] = now() - start;
+
+        start = now();
+        for (int j = 0; j < iterations; j++) {
+            for (int i = 0; i < VALUE_COUNT; i++) {
+                sink = snprintf(buf, sizeof(buf), " [P%d: S%d]", i % 6, i % 8);
+            }
+        }
+        elapsed[4] = now() - start;
+
+        start = now();
+        for (int j = 0; j < iterations; j++) {
+            for (int i = 0; i < VALUE_COUNT; i++) {
+                writer_init(&out, buf, sizeof(buf));
+                write_path_step_index(&out, i % 6, i % 8);
+                sink = out.length;
+            }
+        }
+        elapsed[5] = now() - start;
+
+        for (int k = 0; k < 6; k++) {
+            if (round == 0 || elapsed[k] < timings[k]) {
+                timings[k] = elapsed[k];
+            }
+        }
+    }
+
+    (void) sink;
+
+    double scale = 1e9 / (iterations * VALUE_COUNT);
+    printf("Integer formatting (ns per call)\n");
+    printf("%-12s %10s %10s\n", "format", "snprintf", "print");
+    printf("%-12s %10.1f %10.1f\n", "%u", timings[0] * scale, timings[1] * scale);
+    printf("%-12s %10.1f %10.1f\n", "%u.%07u", timings[2] * scale, timings[3] * scale);
+    printf("%-12s %10.1f %10.1f\n", "[P%d: S%d]", timings[4] * scale, timings[5] * scale);
+    printf("\n");
+}
+
+static void bench_swar(void) {
+    enum { BLOB_SIZE = 1024 };
+    static uint8_t text[BLOB_SIZE];
+    static uint8_t zeros[BLOB_SIZE];
+    static char hex_buf[2 * BLOB_SIZE + 1];
+    static volatile uint64_t sink;
+    textWriter_t out;
+    const int iterations = 20000;
+
+    srand(11);
+    for (int i = 0; i < BLOB_SIZE; i++) {
+        text[i] = 32 + rand() % 95;
+    }
+
+    double timings[8] = {0};
+    for (int round = 0; round < 5; round++) {
+        double elapsed[8];
+        double start;
+
+        start = now();
+        for (int j = 0; j < iterations; j++) {
+            sink = reference_is_purely_ascii(text, BLOB_SIZE, false);
+        }
+        elapsed[0] = now() - start;
+
+        start = now();
+        for (int j = 0; j < iterations; j++) {
+            sink = is_purely_ascii(text, BLOB_SIZE, false);
+        }
+        elapsed[1] = now() - start;
+
+        start = now();
+        for (int j = 0; j < iterations; j++) {
+            sink = reference_is_all_zeros(zeros, BLOB_SIZE);
+        }
+        elapsed[2] = now() - start;
+
+        start = now();
+        for (int j = 0; j < iterations; j++) {
+            sink = is_all_zeros(zeros, BLOB_SIZE);
+        }
+        elapsed[3] = now() - start;
+
+        start = now();
+        for (int j = 0; j < iterations; j++) {
+            writer_init(&out, hex_buf, sizeof(hex_buf));
+            reference_write_hex(&out, text, BLOB_SIZE);
+            sink = out.length;
+        }
+        elapsed[4] = now() - start;
+
+        start = now();
+        for (int j = 0; j < iterations; j++) {
+            writer_init(&out, hex_buf, sizeof(hex_buf));
+            write_hex(&out, text, BLOB_SIZE);
+            sink = out.length;
+        }
+        elapsed[5] = now() - start;
+
+        // One 64-bit read per 8 bytes of the blob, the same count as the checks above
+        start = now();
+        for (int j = 0; j < iterations; j++) {
+            for (int i = 0; i < BLOB_SIZE; i += 8) {
+                sink = reference_read_unsigned64(text + i);
+            }
+        }
+        elapsed[6] = now() - start;
+
+        start = now();
+        for (int j = 0; j < iterations; j++) {
+            for (int i = 0; i < BLOB_SIZE; i += 8) {
+                sink = read_unsigned64(text + i);
+            }
+        }
+        elapsed[7] = now() - start;
+
+        for (int k = 0; k < 8; k++) {
+            if (round == 0 || elapsed[k] < timings[k]) {
+                timings[k] = elapsed[k];
+            }
+        }
+    }
+
+    (void) sink;
+
+    double megabytes = (double) iterations * BLOB_SIZE / 1e6;
+    printf("Byte scans on %d byte blobs (MB/s)\n", BLOB_SIZE);
+    printf("%-16s %10s %10s\n", "helper", "bytewise", "words");
+    printf("%-16s %10.0f %10.0f\n", "is_purely_ascii", megabytes / timings[0],
+           megabytes / timings[1]);
+    printf("%-16s %10.0f %10.0f\n", "is_all_zeros", megabytes / timings[2],
+           megabytes / timings[3]);
+    printf("%-16s %10.0f %10.0f\n", "write_hex", megabytes / timings[4],
+           megabytes / timings[5]);
+    printf("%-16s %10.0f %10.0f\n", "read_unsigned64", megabytes / timings[6],
+           megabytes / timings[7]);
+    printf("\n");
+}
+
+static void bench_flags(void) {
+    static const struct {
+        const char *name;
+        uint16_t type;
+    } types[] = {
+        {"Payment", TRANSACTION_PAYMENT},
+        {"AccountSet", TRANSACTION_ACCOUNT_SET},
+        {"OfferCreate", TRANSACTION_OFFER_CREATE},
+        {"ChannelClaim", TRANSACTION_PAYMENT_CHANNEL_CLAIM},
+        {"TrustSet", TRANSACTION_TRUST_SET},
+        {"NFTokenMint", TRANSACTION_NFTOKEN_MINT},
+        {"NFTokenOffer", TRANSACTION_NFTOKEN_CREATE_OFFER},
+    };
+    // Every combination of the flag bits 0-5 and 16-21, which hold all known flags
+    enum { COMBINATIONS = 1 << 12 };
+    static volatile size_t sink;
+    uint8_t data[4];
+    field_t field = {.offset = 0, .length = sizeof(data), .data_type = STI_UINT32};
+    field.id = XRP_UINT32_FLAGS;
+    char buf[MAX_FIELD_LEN];
+    textWriter_t out;
+    const int iterations = 50;
+
+    memset(&parse_context, 0, sizeof(parse_context));
+    parse_context.data = data;
+    parse_context.length = sizeof(data);
+
+    printf("Flag formatting, all %d combinations (ns per field)\n", COMBINATIONS);
+    printf("%-14s %10s %10s\n", "type", "functions", "tables");
+    for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); t++) {
+        parse_context.transaction_type = types[t].type;
+        parse_context.transaction_info = get_transaction_info(types[t].type);
+        uint8_t flag_set = parse_context.transaction_info->flag_set;
+
+        double timings[2] = {0};
+        for (int round = 0; round < 5; round++) {
+            double elapsed[2];
+            double start;
+
+            start = now();
+            for (int j = 0; j < iterations; j++) {
+                for (uint32_t c = 0; c < COMBINATIONS; c++) {
+                    uint32_t value = (c & 0x3f) | ((c & 0xfc0) << 10);
+                    writer_init(&out, buf, sizeof(buf));
+                    reference_format_flags(flag_set, field.id, value, types[t].type, &out);
+                    sink = out.length;
+                }
+            }
+            elapsed[0] = now() - start;
+
+            start = now();
+            for (int j = 0; j < iterations; j++) {
+                for (uint32_t c = 0; c < COMBINATIONS; c++) {
+                    uint32_t value = (c & 0x3f) | ((c & 0xfc0) << 10);
+                    data[0] = value >> 24;
+                    data[1] = value >> 16;
+                    data[2] = value >> 8;
+                    data[3] = value;
+                    writer_init(&out, buf, sizeof(buf));
+                    format_flags(&parse_context, &field, &out);
+                    sink = out.length;
+                }
+            }
+            elapsed[1] = now() - start;
+
+            for (int k = 0; k < 2; k++) {
+                if (round == 0 || elapsed[k] < timings[k]) {
+                    timings[k] = elapsed[k];
+                }
+            }
+        }
+
+        double scale = 1e9 / (iterations * COMBINATIONS);
+        printf("%-14s %10.1f %10.1f\n", types[t].name, timings[0] * scale, timings[1] * scale);
+    }
+    printf("\n");
+
+    (void) sink;
+}
+
+int main() {
+    bench_transaction_hash();
+#ifndef PARSE_CHECKPOINT_INTERVAL
+    bench_sort_fields();
+#endif
+    bench_field_access();
+    bench_base58();
+    bench_time();
+    bench_print();
+    bench_swar();
+    bench_flags();
+
+    load_all_testcases();
+    bench_hidden_fields();
+    bench_parse_throughput();
+    bench_format_cache();
+#ifndef PARSE_CHECKPOINT_INTERVAL
+    bench_simple_payment();
+#endif
+    return 0;
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Decimal formatting the app used before extracting digits with 32-bit multiplications,
+// kept as the reference the new code is checked against.
+
+// Defined in xrp_helpers.c
+bool adjust_decimals(const char *src,
+                     uint32_t src_length,
+                     char *target,
+                     uint32_t target_length,
+                     uint8_t decimals);
+
+// xrp_print_amount
+static inline int reference_print_amount(uint64_t amount, char *out, size_t outlen) {
+    char tmp[20];
+    uint32_t num_digits = 0, i;
+    uint64_t base;
+
+    for (base = 1; base <= amount; base *= 10) {
+        num_digits++;
+        if (num_digits > sizeof(tmp) - 1) {
+            return -1;
+        }
+    }
+
+    base /= 10;
+    for (i = 0; i < num_digits; i++) {
+        tmp[i] = '0' + (amount / base) % 10;
+        base /= 10;
+    }
+    tmp[i] = '\0';
+
+    char tmp2[25];
+    strncpy(tmp2, "XRP ", sizeof(tmp2));
+    if (!adjust_decimals(tmp, i, tmp2 + 4, sizeof(tmp2) - 4, 6)) {
+        return -1;
+    }
+
+    if (strlen(tmp2) >= outlen - 1) {
+        out[0] = '\0';
+        return -1;
+    }
+    strncpy(out, tmp2, outlen);
+
+    return 0;
+}
+
+static inline int reference_print_uint64(char *dst, uint16_t len, uint64_t value) {
+    uint16_t num_digits = 0, i;
+    uint64_t base = 1;
+
+    while (base <= value) {
+        base *= 10;
+        num_digits++;
+    }
+
+    if (num_digits > len - 1) {
+        return -1;
+    }
+
+    base /= 10;
+    for (i = 0; i < num_digits; i++) {
+        dst[i] = '0' + (value / base) % 10;
+        base /= 10;
+    }
+
+    dst[i] = '\x00';
+
+    return 0;
+}
+
+static inline int reference_decimal_number(char *dst,
+                                           size_t max_len,
+                                           uint8_t sign,
+                                           int16_t exponent,
+                                           uint64_t mantissa) {
+    if (max_len < 100) {
+        return -1;
+    }
+
+    if (sign == 0 && exponent == 0 && mantissa == 0) {
+        dst[0] = '0';
+        return 0;
+    }
+
+    if (exponent < -96 || exponent > 80) {
+        return -1;
+    }
+
+    if (mantissa < 1000000000000000 || mantissa > 9999999999999999) {
+        return -1;
+    }
+
+    if (sign == 0) {
+        dst[0] = '-';
+
+        dst++;
+        max_len--;
+    }
+
+    while (mantissa > 0 && mantissa % 10 == 0) {
+        mantissa = mantissa / 10;
+        exponent++;
+    }
+
+    if (reference_print_uint64(dst, max_len, mantissa) != 0) {
+        return -1;
+    }
+
+    size_t len = strlen(dst);
+    int16_t decimal_pos = len + exponent;
+
+    if (exponent >= 0) {
+        memset(dst + len, '0', exponent);
+    } else if (decimal_pos > 0) {
+        memmove(dst + decimal_pos + 1, dst + decimal_pos, len);
+        dst[decimal_pos] = '.';
+    } else {
+        memmove(dst - decimal_pos + 2, dst, len);
+        memset(dst, '0', -decimal_pos + 2);
+        dst[1] = '.';
+    }
+
+    return 0;
+}
+
+// format_issued_currency, after the currency code has been written to buf
+static inline int reference_issued_currency(uint64_t value, char *buf, size_t size) {
+    uint8_t sign = (uint8_t) ((value >> 62u) & 0x01u);
+    int16_t exponent = (int16_t) (((value >> 54u) & 0xFFu) - 97);
+    uint64_t mantissa = value & 0x3FFFFFFFFFFFFFu;
+    size_t len = strlen(buf);
+    char *p;
+
+    p = buf + len;
+    size -= len;
+
+    if (size == 0) {
+        return -1;
+    }
+
+    if (len > 0) {
+        *p++ = ' ';
+        size--;
+    }
+
+    if (value << 1u == 0) {
+        *p++ = '0';
+        size--;
+        return 0;
+    }
+
+    return reference_decimal_number(p, size, sign, exponent, mantissa);
+}
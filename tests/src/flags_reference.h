@@ -0,0 +1,264 @@
+#pragma once
+
+#include <stdint.h>
+
+// Flag formatting the app used before the descriptor tables, one hand-written function
+// per transaction type, kept as the reference the tables are checked against.
+
+#define REFERENCE_HAS_FLAG(value, flag) ((value) & (flag)) == flag
+
+static inline void reference_append_item(textWriter_t *out, const char *item) {
+    if (out->length != 0) {
+        write_string(out, ", ");
+    }
+
+    write_string(out, item);
+}
+
+static inline void reference_format_account_set_transaction_flags(uint32_t value,
+                                                                  textWriter_t *out) {
+// AccountSet flags
+#define TF_REQUIRE_DEST_TAG  0x00010000u
+#define TF_OPTIONAL_DEST_TAG 0x00020000u
+#define TF_REQUIRE_AUTH      0x00040000u
+#define TF_OPTIONAL_AUTH     0x00080000u
+#define TF_DISALLOW_XRP      0x00100000u
+#define TF_ALLOW_XRP         0x00200000u
+
+    if (REFERENCE_HAS_FLAG(value, TF_REQUIRE_DEST_TAG)) {
+        reference_append_item(out, "Require Dest Tag");
+    }
+
+    if (REFERENCE_HAS_FLAG(value, TF_OPTIONAL_DEST_TAG)) {
+        reference_append_item(out, "Optional Dest Tag");
+    }
+
+    if (REFERENCE_HAS_FLAG(value, TF_REQUIRE_AUTH)) {
+        reference_append_item(out, "Require Auth");
+    }
+
+    if (REFERENCE_HAS_FLAG(value, TF_OPTIONAL_AUTH)) {
+        reference_append_item(out, "Optional Auth");
+    }
+
+    if (REFERENCE_HAS_FLAG(value, TF_DISALLOW_XRP)) {
+        reference_append_item(out, "Disallow XRP");
+    }
+
+    if (REFERENCE_HAS_FLAG(value, TF_ALLOW_XRP)) {
+        reference_append_item(out, "Allow XRP");
+    }
+}
+
+static inline const char *reference_format_account_set_field_flags(uint32_t value) {
+// AccountSet flags for fields SetFlag and ClearFlag
+#define ASF_ACCOUNT_TXN_ID 5
+#define ASF_DEFAULT_RIPPLE 8
+#define ASF_DEPOSIT_AUTH   9
+#define ASF_DISABLE_MASTER 4
+#define ASF_DISALLOW_XRP   3
+#define ASF_GLOBAL_FREEZE  7
+#define ASF_NO_FREEZE      6
+#define ASF_REQUIRE_AUTH   2
+#define ASF_REQUIRE_DEST   1
+
+    // Logic is different because only one flag is allowed per field
+    switch (value) {
+        case ASF_ACCOUNT_TXN_ID:
+            return "Track Txn ID";
+        case ASF_DEFAULT_RIPPLE:
+            return "Ripple by default";
+        case ASF_DEPOSIT_AUTH:
+            return "Deposit Auth";
+        case ASF_DISABLE_MASTER:
+            return "Disable Master";
+        case ASF_DISALLOW_XRP:
+            return "Disallow XRP";
+        case ASF_GLOBAL_FREEZE:
+            return "Global Freeze";
+        case ASF_NO_FREEZE:
+            return "No Freeze";
+        case ASF_REQUIRE_AUTH:
+            return "Require Auth";
+        case ASF_REQUIRE_DEST:
+            return "Require Dest";
+        default:
+            return NULL;
+    }
+}
+
+static inline void reference_format_account_set_flags(uint8_t field_id,
+                                                      uint32_t value,
+                                                      textWriter_t *out) {
+    if (field_id == XRP_UINT32_FLAGS) {
+        reference_format_account_set_transaction_flags(value, out);
+    } else {
+        const char *flag = reference_format_account_set_field_flags(value);
+        if (flag != NULL) {
+            write_string(out, flag);
+        } else {
+            write_string(out, "Unknown flag: ");
+            write_uint(out, value);
+        }
+    }
+}
+
+static inline void reference_format_offer_create_flags(uint32_t value, textWriter_t *out) {
+// OfferCreate flags
+#define TF_PASSIVE             0x00010000u
+#define TF_IMMEDIATE_OR_CANCEL 0x00020000u
+#define TF_FILL_OR_KILL        0x00040000u
+#define TF_SELL                0x00080000u
+
+    if (REFERENCE_HAS_FLAG(value, TF_PASSIVE)) {
+        reference_append_item(out, "Passive");
+    }
+
+    if (REFERENCE_HAS_FLAG(value, TF_IMMEDIATE_OR_CANCEL)) {
+        reference_append_item(out, "Immediate or Cancel");
+    }
+
+    if (REFERENCE_HAS_FLAG(value, TF_FILL_OR_KILL)) {
+        reference_append_item(out, "Fill or Kill");
+    }
+
+    if (REFERENCE_HAS_FLAG(value, TF_SELL)) {
+        reference_append_item(out, "Sell");
+    }
+}
+
+static inline void reference_format_payment_flags(uint32_t value, textWriter_t *out) {
+// Payment flags
+#define TF_NO_RIPPLE_DIRECT 0x00010000u
+#define TF_PARTIAL_PAYMENT  0x00020000u
+#define TF_LIMIT_QUALITY    0x00040000u
+
+    if (REFERENCE_HAS_FLAG(value, TF_NO_RIPPLE_DIRECT)) {
+        reference_append_item(out, "No Direct Ripple");
+    }
+
+    if (REFERENCE_HAS_FLAG(value, TF_PARTIAL_PAYMENT)) {
+        reference_append_item(out, "Partial Payment");
+    }
+
+    if (REFERENCE_HAS_FLAG(value, TF_LIMIT_QUALITY)) {
+        reference_append_item(out, "Limit Quality");
+    }
+}
+
+static inline void reference_format_trust_set_flags(uint32_t value, textWriter_t *out) {
+// TrustSet flags
+#define TF_SETF_AUTH       0x00010000u
+#define TF_SET_NO_RIPPLE   0x00020000u
+#define TF_CLEAR_NO_RIPPLE 0x00040000u
+#define TF_SET_FREEZE      0x00100000u
+#define TF_CLEAR_FREEZE    0x00200000u
+
+    if (REFERENCE_HAS_FLAG(value, TF_SETF_AUTH)) {
+        reference_append_item(out, "Setf Auth");
+    }
+
+    if (REFERENCE_HAS_FLAG(value, TF_SET_NO_RIPPLE)) {
+        reference_append_item(out, "Set No Ripple");
+    }
+
+    if (REFERENCE_HAS_FLAG(value, TF_CLEAR_NO_RIPPLE)) {
+        reference_append_item(out, "Clear No Ripple");
+    }
+
+    if (REFERENCE_HAS_FLAG(value, TF_SET_FREEZE)) {
+        reference_append_item(out, "Set Freeze");
+    }
+
+    if (REFERENCE_HAS_FLAG(value, TF_CLEAR_FREEZE)) {
+        reference_append_item(out, "Clear Freeze");
+    }
+}
+
+static inline void reference_format_payment_channel_claim_flags(uint32_t value,
+                                                                textWriter_t *out) {
+// PaymentChannelClaim flags
+#define TF_RENEW 0x00010000u
+#define TF_CLOSE 0x00020000u
+
+    if (REFERENCE_HAS_FLAG(value, TF_RENEW)) {
+        reference_append_item(out, "Renew");
+    }
+
+    if (REFERENCE_HAS_FLAG(value, TF_CLOSE)) {
+        reference_append_item(out, "Close");
+    }
+}
+
+static inline void reference_format_nftoken_mint_flags(uint32_t value, textWriter_t *out) {
+// NFTokenMint flags
+#define TF_BURNABLE     0x00000001u
+#define TF_ONLY_XRP     0x00000002u
+#define TF_TRUST_LINE   0x00000004u
+#define TF_TRANSFERABLE 0x00000008u
+
+    if (REFERENCE_HAS_FLAG(value, TF_BURNABLE)) {
+        reference_append_item(out, "Burnable");
+    }
+
+    if (REFERENCE_HAS_FLAG(value, TF_ONLY_XRP)) {
+        reference_append_item(out, "Only XRP");
+    }
+
+    if (REFERENCE_HAS_FLAG(value, TF_TRUST_LINE)) {
+        reference_append_item(out, "Trust Line");
+    }
+
+    if (REFERENCE_HAS_FLAG(value, TF_TRANSFERABLE)) {
+        reference_append_item(out, "Transferable");
+    }
+}
+
+static inline void reference_format_nftoken_create_offer_flags(uint32_t value, textWriter_t *out) {
+// NFTokenCreateOffer flags
+#define TF_SELL_NFTOKEN 0x00000001u
+
+    if (REFERENCE_HAS_FLAG(value, TF_SELL_NFTOKEN)) {
+        reference_append_item(out, "Sell NFToken");
+    }
+}
+
+static inline void reference_format_flags(uint8_t flag_set,
+                                          uint8_t field_id,
+                                          uint32_t value,
+                                          uint16_t transaction_type,
+                                          textWriter_t *out) {
+    switch (flag_set) {
+        case FLAG_SET_ACCOUNT_SET:
+            reference_format_account_set_flags(field_id, value, out);
+            break;
+        case FLAG_SET_OFFER_CREATE:
+            reference_format_offer_create_flags(value, out);
+            break;
+        case FLAG_SET_PAYMENT:
+            reference_format_payment_flags(value, out);
+            break;
+        case FLAG_SET_TRUST_SET:
+            reference_format_trust_set_flags(value, out);
+            break;
+        case FLAG_SET_PAYMENT_CHANNEL_CLAIM:
+            reference_format_payment_channel_claim_flags(value, out);
+            break;
+        case FLAG_SET_NFTOKEN_MINT:
+            reference_format_nftoken_mint_flags(value, out);
+            break;
+        case FLAG_SET_NFTOKEN_CREATE_OFFER:
+            reference_format_nftoken_create_offer_flags(value, out);
+            break;
+        default:
+            write_string(out, "No flags for transaction type ");
+            write_uint(out, transaction_type);
+            return;
+    }
+
+    // Check if no flags were found (despite is_flag_hidden returning false) and respond
+    // appropriately
+    if (out->length == 0) {
+        write_string(out, "Unsupported value");
+    }
+}
@@ -1,4 +1,5 @@
 #include <malloc.h>
+#include <stdlib.h>
 #include <setjmp.h>
 #include <stdarg.h>
 #include <stddef.h>
@@ -31,26 +32,61 @@ static void update_title(field_t *field, field_name_t *title) {
 }
 
 static void update_value(field_t *field, field_value_t *value) {
-    format_field(field, value);
+    format_field(&parse_context, field, value);
 }
 
 static void reset_transaction_context(void) {
     explicit_bzero(&parse_context, sizeof(parse_context));
 }
 
+#ifndef PARSE_CHECKPOINT_INTERVAL
+// Parse the data again one byte at a time, which never takes the fast path for simple
+// payments, and abort if the result differs
+static void check_general_parser(const uint8_t *Data, size_t Size, int expected) {
+    static parseContext_t general_context;
+
+    explicit_bzero(&general_context, sizeof(general_context));
+    general_context.data = (uint8_t *) Data;
+    parse_tx_init(&general_context);
+
+    int err = 0;
+    while (err == 0 && general_context.length < Size) {
+        general_context.length++;
+        err = parse_tx_update(&general_context);
+    }
+    if (err == 0) {
+        err = parse_tx_finish(&general_context);
+    }
+
+    if (err != expected) {
+        abort();
+    }
+
+    if (err == 0 && (general_context.result.num_fields != parse_context.result.num_fields ||
+                     memcmp(general_context.result.fields,
+                            parse_context.result.fields,
+                            parse_context.result.num_fields * sizeof(field_t)) != 0)) {
+        abort();
+    }
+}
+#endif
+
 int LLVMFuzzerTestOneInput(const uint8_t *Data, size_t Size) {
     // Reset old transaction data that might still remain
     reset_transaction_context();
     parse_context.data = (uint8_t *)Data;
     parse_context.length = Size;
 
-    if (parse_tx(&parse_context) != 0) {
+    int err = parse_tx(&parse_context);
+#ifndef PARSE_CHECKPOINT_INTERVAL
+    check_general_parser(Data, Size, err);
+#endif
+    if (err != 0) {
         return 0;
     }
 
-    parseResult_t *transaction = &parse_context.result;
-    for (int i = 0; i < transaction->num_fields; ++i) {
-        field_t *field = &transaction->fields[i];
+    for (int i = 0; i < get_field_count(&parse_context); ++i) {
+        field_t *field = get_field(&parse_context, i);
         printf("%x\n", field->id);
         update_title(field, &field_name);
         update_value(field, &field_value);
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Byte-at-a-time versions of the helpers that now work on 32-bit words, kept as the
+// reference the word versions are checked against.
+
+static inline bool reference_is_purely_ascii(const uint8_t *data,
+                                             uint16_t length,
+                                             bool allow_suffix) {
+    bool tracking_suffix = false;
+
+    for (uint16_t i = 0; i < length; ++i) {
+        if (tracking_suffix && data[i] != 0) {
+            return false;
+        }
+
+        if (data[i] == 0 && i > 0 && allow_suffix) {
+            tracking_suffix = true;
+            continue;
+        }
+
+        if (data[i] < 32 || data[i] > 126) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static inline bool reference_is_all_zeros(const uint8_t *data, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        if (data[i] != 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static inline char reference_hex(uint8_t n) {
+    return n >= 10 ? 'a' + (n - 10) : '0' + n;
+}
+
+// Writes the hex digits pair by pair, like the writer did before, so the truncation
+// of a pair that only half fits can be compared too
+static inline void reference_write_hex(textWriter_t *out, const uint8_t *data, size_t length) {
+    char pair[2];
+
+    for (size_t i = 0; i < length && !out->overflow; i++) {
+        pair[0] = reference_hex(data[i] >> 4);
+        pair[1] = reference_hex(data[i] & 0xf);
+        write_chars(out, pair, sizeof(pair));
+    }
+}
+
+static inline uint64_t reference_read_unsigned64(const uint8_t *src) {
+    uint64_t value = 0;
+    const size_t num_bytes = 8;
+    for (uint8_t i = 0; i < num_bytes; ++i) {
+        value |= (uint64_t) src[i] << (num_bytes * 8u - i * 8u - 8u);
+    }
+
+    return value;
+}
@@ -1,6 +1,10 @@
 #include <setjmp.h>
 #include <stdarg.h>
 #include <stddef.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <cmocka.h>
@@ -8,6 +12,20 @@
 #include "cx.h"
 #include "../src/xrp/xrp_parse.h"
 #include "../src/xrp/xrp_helpers.h"
+#include "../src/xrp/address_cache.h"
+#include "../src/xrp/amount.h"
+#include "../src/xrp/ascii_strings.h"
+#include "../src/xrp/flags.h"
+#include "../src/xrp/number_helpers.h"
+#include "../src/xrp/readers.h"
+#include "../src/xrp/text_writer.h"
+#include "../src/xrp/time.h"
+#include "../src/xrp/transaction_types.h"
+#include "base58_reference.h"
+#include "decimal_reference.h"
+#include "flags_reference.h"
+#include "swar_reference.h"
+#include "time_reference.h"
 
 parseContext_t parse_context;
 
@@ -47,10 +65,485 @@ void test_print_amount(void **state) {
     assert_int_equal(xrp_print_amount(amount + 1, buf, sizeof(buf)), -1);
 }
 
+void test_base58_differential(void **state) {
+    (void) state;
+
+    xrp_account_t account;
+    uint8_t payload[26];
+    char expected[64];
+    xrp_address_t address;
+
+    srand(58);
+    for (int i = 0; i < 100000; i++) {
+        // Runs of leading zero bytes exercise the 'r' prefix, high versions the 26 bytes case
+        size_t zeros = rand() % 4 == 0 ? rand() % 21 : 0;
+        uint16_t version = rand() % 8 == 0 ? rand() % 65536 : 0;
+        for (size_t j = 0; j < sizeof(account.buf); j++) {
+            account.buf[j] = j < zeros ? 0 : rand();
+        }
+
+        size_t length = reference_account_payload(account.buf, version, payload);
+        size_t expected_length = reference_encode_base58(payload, length, expected, NULL);
+
+        memset(&address, 0, sizeof(address));
+        size_t address_length =
+            xrp_public_key_to_encoded_base58(NULL, &account, &address, version);
+
+        assert_int_equal(address_length, expected_length);
+        assert_memory_equal(address.buf, expected, expected_length);
+    }
+}
+
+void test_address_cache(void **state) {
+    (void) state;
+
+    addressCache_t cache;
+    xrp_account_t accounts[ADDRESS_CACHE_SIZE + 1];
+    xrp_address_t expected;
+
+    for (size_t i = 0; i < ADDRESS_CACHE_SIZE + 1; i++) {
+        memset(accounts[i].buf, 0x11 * (i + 1), sizeof(accounts[i].buf));
+    }
+
+    address_cache_reset(&cache);
+    const cachedAddress_t *entry = get_encoded_address(&cache, &accounts[0]);
+    size_t length = xrp_public_key_to_encoded_base58(NULL, &accounts[0], &expected, 0);
+    assert_int_equal(entry->length, length);
+    assert_memory_equal(entry->address, expected.buf, length);
+
+    // Encoded once per transaction
+    assert_ptr_equal(get_encoded_address(&cache, &accounts[0]), entry);
+    assert_int_equal(cache.count, 1);
+
+    for (size_t i = 1; i < ADDRESS_CACHE_SIZE; i++) {
+        get_encoded_address(&cache, &accounts[i]);
+    }
+    assert_int_equal(cache.count, ADDRESS_CACHE_SIZE);
+    assert_ptr_equal(get_encoded_address(&cache, &accounts[0]), entry);
+
+    // The oldest account is replaced by the next one
+    entry = get_encoded_address(&cache, &accounts[ADDRESS_CACHE_SIZE]);
+    length = xrp_public_key_to_encoded_base58(NULL, &accounts[ADDRESS_CACHE_SIZE], &expected, 0);
+    assert_int_equal(entry->length, length);
+    assert_memory_equal(entry->address, expected.buf, length);
+    assert_memory_equal(entry->account.buf, accounts[ADDRESS_CACHE_SIZE].buf, XRP_ACCOUNT_SIZE);
+    assert_int_equal(cache.count, ADDRESS_CACHE_SIZE);
+}
+
+static uint64_t next_random(uint64_t *state) {
+    // xorshift64
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+void test_decimal_differential(void **state) {
+    (void) state;
+
+    uint64_t random = 0x5852505f414d4f55;
+    char digits[MAX_DECIMAL_DIGITS];
+    char expected[32];
+
+    // Every magnitude up to UINT64_MAX, XRP amounts stop at 19 digits
+    for (int i = 0; i < 2000000; i++) {
+        uint64_t value = next_random(&random) >> (i % 64);
+        char buf[32];
+
+        // Zero has no digits
+        snprintf(expected, sizeof(expected), "%" PRIu64, value);
+        uint8_t length = decimal_digits(value, digits);
+        assert_int_equal(length, value == 0 ? 0 : strlen(expected));
+        assert_memory_equal(digits, expected, length);
+
+        int expected_error = reference_print_amount(value, expected, sizeof(expected));
+        assert_int_equal(xrp_print_amount(value, buf, sizeof(buf)), expected_error);
+        if (expected_error == 0) {
+            assert_string_equal(buf, expected);
+        }
+    }
+
+    // Issued currency amounts: mantissas with trailing zeros, out of range mantissas and
+    // exponents, and both signs
+    static const uint64_t powers[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000};
+    uint8_t data[48] = {0};
+    field_t field = {.offset = 0, .length = 48, .data_type = STI_AMOUNT};
+    field_value_t value;
+    field_value_t reference;
+    textWriter_t out;
+
+    memcpy(&data[20], "USD", 3);
+    parse_context.data = data;
+    parse_context.length = sizeof(data);
+    for (int i = 0; i < 1000000; i++) {
+        uint64_t r = next_random(&random);
+        uint64_t mantissa = 1000000000000000 + r % 9000000000000000;
+        mantissa -= mantissa % powers[(r >> 56) % 8];
+        if (i % 64 == 0) {
+            mantissa = r & 0x3FFFFFFFFFFFFF;
+        }
+
+        uint64_t amount = 0x8000000000000000 | (r & 0x4000000000000000) |
+                          (next_random(&random) & 0x3FC0000000000000) | mantissa;
+        for (int j = 0; j < 8; j++) {
+            data[j] = amount >> (56 - 8 * j);
+        }
+
+        // The formatters don't rely on a cleared buffer
+        memset(&value, 'x', sizeof(value));
+        writer_init(&out, value.buf, sizeof(value.buf));
+        amount_formatter(&parse_context, &field, &out);
+
+        memset(&reference, 0, sizeof(reference));
+        memcpy(reference.buf, "USD", 3);
+        if (reference_issued_currency(amount, reference.buf, sizeof(reference.buf)) != 0) {
+            strncpy(reference.buf, "Invalid amount!", sizeof(reference.buf));
+        }
+        assert_string_equal(value.buf, reference.buf);
+        assert_int_equal(out.length, strlen(reference.buf));
+    }
+}
+
+static void check_time(uint32_t t) {
+    uint8_t data[4] = {t >> 24, t >> 16, t >> 8, t};
+    field_t field = {.length = 4, .data_type = STI_UINT32, .id = XRP_UINT32_EXPIRATION};
+    field_value_t value;
+    textWriter_t out;
+    char expected[32];
+
+    parse_context.data = data;
+    parse_context.length = sizeof(data);
+    memset(&value, 'x', sizeof(value));
+    writer_init(&out, value.buf, sizeof(value.buf));
+    format_time(&parse_context, &field, &out);
+
+    reference_format_time(t, expected, sizeof(expected));
+    assert_string_equal(value.buf, expected);
+}
+
+void test_time_differential(void **state) {
+    (void) state;
+
+    // Around midnight, the first hours and minutes of every day up to 2136-02-07
+    static const uint32_t offsets[] = {0, 1, 59, 60, 3599, 3600, 43200, 86340, 86399};
+    for (uint32_t day = 0; day <= UINT32_MAX / 86400; day++) {
+        for (size_t i = 0; i < sizeof(offsets) / sizeof(offsets[0]); i++) {
+            uint64_t t = (uint64_t) day * 86400 + offsets[i];
+            if (t <= UINT32_MAX) {
+                check_time(t);
+            }
+        }
+    }
+
+    // The last day, then random times
+    for (uint32_t t = UINT32_MAX - 86400; t != 0; t++) {
+        check_time(t);
+    }
+
+    uint64_t random = 0x54494d45;
+    for (int i = 0; i < 1000000; i++) {
+        check_time(next_random(&random));
+    }
+}
+
+void test_text_writer(void **state) {
+    (void) state;
+
+    char buf[32];
+    char expected[32];
+    textWriter_t out;
+
+    uint64_t random = 0x7072696e74;
+    for (int i = 0; i < 1000000; i++) {
+        uint32_t value = next_random(&random) >> (i % 32 + 32);
+        uint8_t width = i % 12;
+
+        snprintf(expected, sizeof(expected), "%u", value);
+        writer_init(&out, buf, sizeof(buf));
+        write_uint(&out, value);
+        assert_int_equal(out.length, strlen(expected));
+        assert_string_equal(buf, expected);
+
+        snprintf(expected, sizeof(expected), "%0*u", width, value);
+        writer_init(&out, buf, sizeof(buf));
+        write_uint_padded(&out, value, width);
+        assert_int_equal(out.length, strlen(expected));
+        assert_string_equal(buf, expected);
+    }
+
+    writer_init(&out, buf, sizeof(buf));
+    write_string(&out, "Memo");
+    write_array_index(&out, 7);
+    assert_string_equal(buf, "Memo [7]");
+
+    writer_init(&out, buf, sizeof(buf));
+    write_string(&out, "Path");
+    write_path_step_index(&out, 5, 12);
+    assert_string_equal(buf, "Path [P5: S12]");
+
+    writer_init(&out, buf, sizeof(buf));
+    write_hex(&out, (const uint8_t *) "\x01\xab\xff", 3);
+    write_repeat(&out, ' ', 2);
+    write_char(&out, '!');
+    assert_string_equal(buf, "01abff  !");
+    assert_false(out.overflow);
+
+    // A write that doesn't fit is cut and ends with "...", the next ones are ignored
+    writer_init(&out, buf, 8);
+    write_string(&out, "Flag");
+    write_uint(&out, 123456);
+    assert_true(out.overflow);
+    assert_string_equal(buf, "Flag...");
+    write_string(&out, "x");
+    assert_string_equal(buf, "Flag...");
+    assert_int_equal(out.length, 7);
+
+    writer_init(&out, buf, 8);
+    write_hex(&out, (const uint8_t *) "\x01\x02\x03\x04", 4);
+    assert_string_equal(buf, "0102...");
+
+    writer_init(&out, buf, 3);
+    write_string(&out, "abc");
+    assert_true(out.overflow);
+    assert_string_equal(buf, "ab");
+
+    // Exactly full is not an overflow
+    writer_init(&out, buf, 4);
+    write_string(&out, "abc");
+    assert_false(out.overflow);
+    assert_string_equal(buf, "abc");
+
+    writer_reset(&out);
+    write_string(&out, "Invalid");
+    assert_string_equal(buf, "...");
+    writer_reset(&out);
+    assert_string_equal(buf, "");
+    assert_false(out.overflow);
+}
+
+static void assert_ascii_matches(const uint8_t *data, uint16_t length) {
+    assert_int_equal(is_purely_ascii(data, length, false),
+                     reference_is_purely_ascii(data, length, false));
+    assert_int_equal(is_purely_ascii(data, length, true),
+                     reference_is_purely_ascii(data, length, true));
+}
+
+void test_ascii_differential(void **state) {
+    (void) state;
+
+    // Four spare bytes in front, so that every alignment of the data is covered
+    uint8_t buffer[4 + 64];
+
+    for (size_t offset = 0; offset < 4; offset++) {
+        uint8_t *data = buffer + offset;
+
+        for (uint16_t length = 0; length <= 64; length++) {
+            // Every value at every position, in printable text with and without a suffix
+            const uint16_t prefixes[] = {length, 1, length / 2, length - 1};
+            for (size_t p = 0; p < sizeof(prefixes) / sizeof(prefixes[0]); p++) {
+                for (uint16_t pos = 0; pos < length; pos++) {
+                    memset(data, 'a', prefixes[p]);
+                    memset(data + prefixes[p], 0, length - prefixes[p]);
+
+                    for (int value = 0; value < 256; value++) {
+                        data[pos] = value;
+                        assert_ascii_matches(data, length);
+                    }
+                }
+            }
+
+            for (uint16_t pos = 0; pos < length; pos++) {
+                memset(data, 0, length);
+                for (int value = 0; value < 256; value++) {
+                    data[pos] = value;
+                    assert_int_equal(is_all_zeros(data, length),
+                                     reference_is_all_zeros(data, length));
+                }
+            }
+        }
+
+        // Every pair of neighbouring values, where carries between the bytes of a word could
+        // hide a mismatch
+        for (uint16_t pos = 0; pos < 7; pos++) {
+            memset(data, 'a', 8);
+            for (int pair = 0; pair < 65536; pair++) {
+                data[pos] = pair >> 8;
+                data[pos + 1] = pair & 0xff;
+                assert_ascii_matches(data, 8);
+            }
+        }
+    }
+
+    uint64_t random = 0x6173636969;
+    for (int i = 0; i < 200000; i++) {
+        uint64_t bits = next_random(&random);
+        uint16_t length = bits % 65;
+        size_t offset = (bits >> 8) % 4;
+
+        for (uint16_t j = 0; j < length; j++) {
+            // Mostly printable text, with a few nulls and other bytes in it
+            uint64_t r = next_random(&random);
+            buffer[offset + j] = r % 16 == 0 ? 0 : r % 32 == 1 ? r >> 8 : 32 + (r >> 8) % 95;
+        }
+        assert_ascii_matches(buffer + offset, length);
+    }
+}
+
+void test_hex_differential(void **state) {
+    (void) state;
+
+    uint8_t buffer[4 + 256];
+    char buf[128];
+    char expected[128];
+    textWriter_t out;
+    textWriter_t reference;
+
+    for (int i = 0; i < 256; i++) {
+        buffer[4 + i] = i;
+    }
+
+    char all_bytes[513];
+    char all_expected[513];
+    writer_init(&out, all_bytes, sizeof(all_bytes));
+    writer_init(&reference, all_expected, sizeof(all_expected));
+    write_hex(&out, buffer + 4, 256);
+    reference_write_hex(&reference, buffer + 4, 256);
+    assert_string_equal(all_bytes, all_expected);
+    assert_false(out.overflow);
+
+    // Every capacity around every length, from a few starting positions
+    uint64_t random = 0x686578;
+    for (size_t offset = 0; offset < 4; offset++) {
+        for (size_t length = 0; length <= 40; length++) {
+            for (size_t j = 0; j < length; j++) {
+                buffer[offset + j] = next_random(&random);
+            }
+
+            for (size_t prefix = 0; prefix < 6; prefix++) {
+                for (size_t capacity = 0; capacity <= 90; capacity++) {
+                    writer_init(&out, buf, capacity);
+                    writer_init(&reference, expected, capacity);
+                    write_repeat(&out, '-', prefix);
+                    write_repeat(&reference, '-', prefix);
+
+                    write_hex(&out, buffer + offset, length);
+                    reference_write_hex(&reference, buffer + offset, length);
+
+                    assert_int_equal(out.length, reference.length);
+                    assert_int_equal(out.overflow, reference.overflow);
+                    if (capacity > 0) {
+                        assert_string_equal(buf, expected);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void test_read_unsigned64_differential(void **state) {
+    (void) state;
+
+    uint8_t data[8] = {0};
+
+    for (size_t pos = 0; pos < sizeof(data); pos++) {
+        memset(data, 0, sizeof(data));
+        for (int value = 0; value < 256; value++) {
+            data[pos] = value;
+            assert_int_equal(read_unsigned64(data), reference_read_unsigned64(data));
+        }
+    }
+
+    uint64_t random = 0x7536;
+    for (int i = 0; i < 1000000; i++) {
+        uint64_t value = next_random(&random);
+        memcpy(data, &value, sizeof(data));
+        assert_int_equal(read_unsigned64(data), reference_read_unsigned64(data));
+    }
+}
+
+// The flag bits used by any transaction type, and a few unknown ones
+static uint32_t spread_flag_bits(uint32_t combination) {
+    return (combination & 0x3f) | ((combination & 0xfc0) << 10) |
+           ((combination & 0x1000) << 19) | ((combination & 0x2000) >> 7);
+}
+
+void test_flags_differential(void **state) {
+    (void) state;
+
+    const uint8_t field_ids[] = {XRP_UINT32_FLAGS, XRP_UINT32_SET_FLAG, XRP_UINT32_CLEAR_FLAG};
+    uint8_t data[4];
+    field_t field = {.offset = 0, .length = sizeof(data), .data_type = STI_UINT32};
+    char buf[MAX_FIELD_LEN];
+    char expected[MAX_FIELD_LEN];
+    textWriter_t out;
+    textWriter_t reference;
+
+    parse_context.data = data;
+    parse_context.length = sizeof(data);
+
+    // Every combination of the flags for every transaction type
+    for (uint16_t type = 0; type < 64; type++) {
+        parse_context.transaction_type = type;
+        parse_context.transaction_info = get_transaction_info(type);
+
+        for (uint32_t combination = 0; combination < 0x4000; combination++) {
+            uint32_t value = spread_flag_bits(combination);
+            data[0] = value >> 24;
+            data[1] = value >> 16;
+            data[2] = value >> 8;
+            data[3] = value;
+
+            for (size_t i = 0; i < sizeof(field_ids); i++) {
+                field.id = field_ids[i];
+
+                writer_init(&out, buf, sizeof(buf));
+                format_flags(&parse_context, &field, &out);
+                writer_init(&reference, expected, sizeof(expected));
+                reference_format_flags(parse_context.transaction_info->flag_set,
+                                       field.id,
+                                       value,
+                                       type,
+                                       &reference);
+
+                assert_string_equal(buf, expected);
+            }
+        }
+    }
+
+    // All flags in a buffer that is too short end with "..." like before
+    parse_context.transaction_info = get_transaction_info(TRANSACTION_ACCOUNT_SET);
+    field.id = XRP_UINT32_FLAGS;
+    memset(data, 0xff, sizeof(data));
+    for (size_t capacity = 0; capacity <= 64; capacity++) {
+        writer_init(&out, buf, capacity);
+        format_flags(&parse_context, &field, &out);
+        writer_init(&reference, expected, capacity);
+        reference_format_flags(FLAG_SET_ACCOUNT_SET,
+                               field.id,
+                               UINT32_MAX,
+                               TRANSACTION_ACCOUNT_SET,
+                               &reference);
+
+        assert_int_equal(out.length, reference.length);
+        if (capacity > 0) {
+            assert_string_equal(buf, expected);
+        }
+    }
+}
+
 int main() {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test(test_address),
         cmocka_unit_test(test_print_amount),
+        cmocka_unit_test(test_base58_differential),
+        cmocka_unit_test(test_address_cache),
+        cmocka_unit_test(test_decimal_differential),
+        cmocka_unit_test(test_time_differential),
+        cmocka_unit_test(test_text_writer),
+        cmocka_unit_test(test_ascii_differential),
+        cmocka_unit_test(test_hex_differential),
+        cmocka_unit_test(test_read_unsigned64_differential),
+        cmocka_unit_test(test_flags_differential),
     };
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
@@ -10,6 +10,10 @@
 #include "../src/xrp/xrp_parse.h"
 #include "../src/xrp/xrp_helpers.h"
 #include "../src/xrp/fmt.h"
+#include "../src/xrp/field_sort.h"
+#include "../src/xrp/field_info.h"
+#include "../src/xrp/format_cache.h"
+#include "../src/xrp/general.h"
 
 parseContext_t parse_context;
 
@@ -130,7 +134,7 @@ static void update_title(field_t *field, field_name_t *title) {
 }
 
 static void update_value(field_t *field, field_value_t *value) {
-    format_field(field, value);
+    format_field(&parse_context, field, value);
 }
 
 static void get_result_filename(const char *filename, char *path, size_t size) {
@@ -141,15 +145,15 @@ static void get_result_filename(const char *filename, char *path, size_t size) {
     memcpy(ext, ".txt", 4);
 }
 
-static void generate_expected_result(const char *filename, parseResult_t *transaction) {
+static void generate_expected_result(const char *filename, parseContext_t *transaction) {
     char path[1024];
     get_result_filename(filename, path, sizeof(path));
 
     FILE *fp = fopen(path, "w");
     assert_non_null(fp);
 
-    for (int i = 0; i < transaction->num_fields; ++i) {
-        field_t *field = &transaction->fields[i];
+    for (int i = 0; i < get_field_count(transaction); ++i) {
+        field_t *field = get_field(transaction, i);
         field_name_t field_name;
         field_value_t field_value;
         update_title(field, &field_name);
@@ -160,7 +164,7 @@ static void generate_expected_result(const char *filename, parseResult_t *transa
     fclose(fp);
 }
 
-static void check_transaction_results(const char *filename, parseResult_t *transaction) {
+static void check_transaction_results(const char *filename, parseContext_t *transaction) {
     // printf("[*] %s\n", filename);
     char path[1024];
     get_result_filename(filename, path, sizeof(path));
@@ -168,8 +172,8 @@ static void check_transaction_results(const char *filename, parseResult_t *trans
     FILE *fp = fopen(path, "r");
     assert_non_null(fp);
 
-    for (int i = 0; i < transaction->num_fields; ++i) {
-        field_t *field = &transaction->fields[i];
+    for (int i = 0; i < get_field_count(transaction); ++i) {
+        field_t *field = get_field(transaction, i);
         field_name_t field_name;
         field_value_t field_value;
         update_title(field, &field_name);
@@ -206,7 +210,7 @@ static void test_tx(const char *filename) {
     parse_context.length = size;
     assert_int_equal(parse_tx(&parse_context), 0);
 
-    parseResult_t *transaction = &parse_context.result;
+    parseContext_t *transaction = &parse_context;
     if (false) {
         generate_expected_result(filename, transaction);
     }
@@ -215,6 +219,26 @@ static void test_tx(const char *filename) {
     free(data);
 }
 
+static void test_tx_chunked(const char *filename, size_t chunk_size) {
+    size_t size;
+    uint8_t *data = load_transaction_data(filename, &size);
+
+    memset(&parse_context, 0, sizeof(parse_context));
+    parse_context.data = data;
+    parse_tx_init(&parse_context);
+
+    while (parse_context.length < size) {
+        size_t remaining = size - parse_context.length;
+        parse_context.length += remaining < chunk_size ? remaining : chunk_size;
+        assert_int_equal(parse_tx_update(&parse_context), 0);
+    }
+    assert_int_equal(parse_tx_finish(&parse_context), 0);
+
+    check_transaction_results(filename, &parse_context);
+
+    free(data);
+}
+
 void test_transactions(void **state) {
     (void) state;
 
@@ -223,9 +247,884 @@ void test_transactions(void **state) {
     }
 }
 
+void test_transactions_chunked(void **state) {
+    (void) state;
+
+    static const size_t chunk_sizes[] = {1, 2, 7, 64, 255};
+
+    for (size_t i = 0; i < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); i++) {
+        for (const char **testcase = testcases; *testcase != NULL; testcase++) {
+            test_tx_chunked(*testcase, chunk_sizes[i]);
+        }
+    }
+}
+
+void test_chunked_early_rejection(void **state) {
+    (void) state;
+
+    // TransactionType followed by a field of the unsupported type UInt64
+    uint8_t data[] = {0x12, 0x00, 0x00, 0x31, 0x00, 0x00};
+
+    memset(&parse_context, 0, sizeof(parse_context));
+    parse_context.data = data;
+    parse_tx_init(&parse_context);
+
+    // The first chunk ends in the middle of the TransactionType field
+    parse_context.length = 2;
+    assert_int_equal(parse_tx_update(&parse_context), 0);
+    assert_int_equal(parse_context.offset, 0);
+
+    // The unsupported field is rejected before the rest of the data is received
+    parse_context.length = 4;
+    assert_int_equal(parse_tx_update(&parse_context), NOT_SUPPORTED);
+}
+
+void test_chunked_truncated(void **state) {
+    (void) state;
+
+    // Account field whose length prefix announces more data than is sent
+    uint8_t data[] = {0x12, 0x00, 0x00, 0x81, 0x14, 0x01, 0x02};
+
+    memset(&parse_context, 0, sizeof(parse_context));
+    parse_context.data = data;
+    parse_context.length = sizeof(data);
+    parse_tx_init(&parse_context);
+
+    assert_int_equal(parse_tx_update(&parse_context), 0);
+    assert_int_equal(parse_context.offset, 3);
+    assert_int_equal(get_field_count(&parse_context), 1);
+    assert_int_equal(parse_tx_finish(&parse_context), EXCEPTION_OVERFLOW);
+}
+
+// Visible fields of the payment below, without the memos
+#define PAYMENT_FIELD_COUNT 5
+
+// Payment with the given number of memos, each of them resulting in 3 fields
+static size_t build_payment_with_memos(uint8_t *data, int memo_count) {
+    size_t size = 0;
+
+    const uint8_t header[] = {0x12, 0x00, 0x00, 0x22, 0x80, 0x00, 0x00, 0x00, 0x61,
+                              0x40, 0x00, 0x00, 0x00, 0x00, 0x0f, 0x42, 0x40, 0x68,
+                              0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0a};
+    memcpy(data, header, sizeof(header));
+    size += sizeof(header);
+
+    // Account and Destination
+    data[size++] = 0x81;
+    data[size++] = 0x14;
+    memset(data + size, 0x42, XRP_ACCOUNT_SIZE);
+    size += XRP_ACCOUNT_SIZE;
+    data[size++] = 0x83;
+    data[size++] = 0x14;
+    memset(data + size, 0x43, XRP_ACCOUNT_SIZE);
+    size += XRP_ACCOUNT_SIZE;
+
+    data[size++] = 0xf9;
+    for (int i = 0; i < memo_count; i++) {
+        const uint8_t memo[] = {0xea, 0x7c, 0x01, 'a', 0x7d, 0x01, 'b', 0x7e, 0x01, 'c', 0xe1};
+        memcpy(data + size, memo, sizeof(memo));
+        size += sizeof(memo);
+    }
+    data[size++] = 0xf1;
+
+    return size;
+}
+
+static int parse_data(uint8_t *data, size_t size) {
+    memset(&parse_context, 0, sizeof(parse_context));
+    parse_context.data = data;
+    parse_context.length = size;
+    return parse_tx(&parse_context);
+}
+
+void test_canonical_order(void **state) {
+    (void) state;
+
+    // AccountSet with TransactionType, Flags and Sequence
+    uint8_t sorted[] = {0x12, 0x00, 0x03, 0x22, 0x80, 0x00, 0x00, 0x00,
+                        0x24, 0x00, 0x00, 0x00, 0x01};
+    assert_int_equal(parse_data(sorted, sizeof(sorted)), 0);
+    assert_true(has_field(&parse_context, STI_UINT16, XRP_UINT16_TRANSACTION_TYPE));
+    assert_true(has_field(&parse_context, STI_UINT32, XRP_UINT32_FLAGS));
+    assert_false(has_field(&parse_context, STI_ACCOUNT, XRP_ACCOUNT_ACCOUNT));
+
+    // Sequence before Flags
+    uint8_t unsorted[] = {0x12, 0x00, 0x03, 0x24, 0x00, 0x00, 0x00, 0x01,
+                          0x22, 0x80, 0x00, 0x00, 0x00};
+    assert_int_equal(parse_data(unsorted, sizeof(unsorted)), INVALID_STATE);
+
+    // Flags twice
+    uint8_t duplicated[] = {0x12, 0x00, 0x03, 0x22, 0x80, 0x00, 0x00, 0x00,
+                            0x22, 0x80, 0x00, 0x00, 0x00};
+    assert_int_equal(parse_data(duplicated, sizeof(duplicated)), INVALID_STATE);
+
+    // Fields of different memos are sorted independently
+    uint8_t memos[] = {0x12, 0x00, 0x03, 0xf9, 0xea, 0x7c, 0x01, 'a', 0x7d, 0x01, 'b', 0xe1,
+                       0xea, 0x7c, 0x01, 'a', 0xe1, 0xf1};
+    assert_int_equal(parse_data(memos, sizeof(memos)), 0);
+
+    // MemoData before MemoType
+    memos[5] = 0x7d;
+    memos[8] = 0x7c;
+    assert_int_equal(parse_data(memos, sizeof(memos)), INVALID_STATE);
+}
+
+void test_nested_arrays(void **state) {
+    (void) state;
+
+    // Memo with a MemoType and a nested SignerEntries array
+    uint8_t nested[] = {0x12, 0x00, 0x03, 0xf9, 0xea, 0x7c, 0x01, 'a', 0xf4, 0xeb, 0x81, 0x14,
+                        0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                        0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0xe1, 0xf1, 0xe1, 0xf1};
+    assert_int_equal(parse_data(nested, sizeof(nested)), 0);
+    assert_int_equal(get_field_count(&parse_context), 3);
+
+    field_t *field = get_field(&parse_context, 1);
+    assert_int_equal(field->id, XRP_VL_MEMO_TYPE);
+    assert_int_equal(field->array_info.type, 9);
+    assert_int_equal(field->array_info.index1, 1);
+
+    // The index of the innermost array is displayed
+    field = get_field(&parse_context, 2);
+    assert_int_equal(field->data_type, STI_ACCOUNT);
+    assert_int_equal(field->array_info.type, 4);
+    assert_int_equal(field->array_info.index1, 1);
+
+    // Unterminated array
+    assert_int_equal(parse_data(nested, sizeof(nested) - 1), INVALID_STATE);
+
+    // Object end at the top level
+    uint8_t object_end[] = {0x12, 0x00, 0x03, 0xe1};
+    assert_int_equal(parse_data(object_end, sizeof(object_end)), INVALID_STATE);
+
+    // Array item that isn't an object
+    uint8_t not_object[] = {0x12, 0x00, 0x03, 0xf9, 0x7c, 0x01, 'a', 0xf1};
+    assert_int_equal(parse_data(not_object, sizeof(not_object)), INVALID_STATE);
+}
+
+// Memos nested in memos up to the given depth
+static size_t build_nested_memos(uint8_t *data, int depth) {
+    size_t size = 0;
+
+    data[size++] = 0x12;
+    data[size++] = 0x00;
+    data[size++] = 0x03;
+    for (int i = 0; i < depth; i++) {
+        data[size++] = i % 2 == 0 ? 0xf9 : 0xea;
+    }
+    for (int i = depth - 1; i >= 0; i--) {
+        data[size++] = i % 2 == 0 ? 0xf1 : 0xe1;
+    }
+
+    return size;
+}
+
+void test_nesting_depth(void **state) {
+    (void) state;
+
+    uint8_t data[64];
+
+    assert_int_equal(parse_data(data, build_nested_memos(data, MAX_NESTING_DEPTH)), 0);
+    assert_int_equal(parse_data(data, build_nested_memos(data, MAX_NESTING_DEPTH + 1)),
+                     NOT_SUPPORTED);
+}
+
+// Append a path set with the given number of visible fields, using path steps with
+// both a currency and an issuer
+static size_t append_path_set(uint8_t *data, size_t size, int field_count) {
+    int path = 1;
+    int step = 1;
+
+    data[size++] = 0x01;
+    data[size++] = 0x12;
+    while (field_count > 0) {
+        if (step > MAX_STEP_COUNT) {
+            data[size++] = 0xff;
+            path++;
+            step = 1;
+        }
+
+        data[size++] = field_count > 1 ? 0x30 : 0x10;
+        memset(data + size, path * 16 + step, 2 * XRP_ACCOUNT_SIZE);
+        size += field_count > 1 ? 2 * XRP_ACCOUNT_SIZE : XRP_CURRENCY_SIZE;
+        field_count -= field_count > 1 ? 2 : 1;
+        step++;
+    }
+    data[size++] = 0x00;
+
+    return size;
+}
+
+#ifndef PARSE_CHECKPOINT_INTERVAL
+void test_hidden_fields_at_capacity(void **state) {
+    (void) state;
+
+    // The path separators and the end of the path set are hidden fields that come
+    // after all field slots have been used
+    uint8_t data[2048];
+    size_t size = build_payment_with_memos(data, 0);
+    size = append_path_set(data, size, MAX_FIELD_COUNT - PAYMENT_FIELD_COUNT);
+
+    assert_int_equal(parse_data(data, size), 0);
+    assert_int_equal(get_field_count(&parse_context), MAX_FIELD_COUNT);
+    assert_int_equal(get_field(&parse_context, MAX_FIELD_COUNT - 1)->data_type, STI_CURRENCY);
+
+    // One more field doesn't fit
+    size = build_payment_with_memos(data, 0);
+    size = append_path_set(data, size, MAX_FIELD_COUNT - PAYMENT_FIELD_COUNT + 1);
+    assert_int_equal(parse_data(data, size), NOT_ENOUGH_SPACE);
+}
+#endif
+
+void test_many_fields(void **state) {
+    (void) state;
+
+    // 8 memos result in more than the 24 fields that could be stored before
+    // field_t was made compact
+    uint8_t data[512];
+
+    memset(&parse_context, 0, sizeof(parse_context));
+    parse_context.data = data;
+    parse_context.length = build_payment_with_memos(data, 8);
+    assert_int_equal(parse_tx(&parse_context), 0);
+    assert_int_equal(get_field_count(&parse_context), PAYMENT_FIELD_COUNT + 8 * 3);
+
+    field_t *field = get_field(&parse_context, PAYMENT_FIELD_COUNT + 8 * 3 - 1);
+    assert_int_equal(field->data_type, STI_VL);
+    assert_int_equal(field->id, XRP_VL_MEMO_FORMAT);
+    assert_int_equal(field->array_info.index1, 8);
+    assert_int_equal(field_data(&parse_context, field)[0], 'c');
+}
+
+static void assert_field_value(const char *title, const char *expected) {
+    for (int i = 0; i < get_field_count(&parse_context); ++i) {
+        field_t *field = get_field(&parse_context, i);
+        if (strcmp(resolve_field_name(field), title) == 0) {
+            field_value_t value;
+            format_field(&parse_context, field, &value);
+            assert_string_equal(value.buf, expected);
+            return;
+        }
+    }
+
+    fail_msg("field %s not found", title);
+}
+
+void test_modern_transaction_types(void **state) {
+    (void) state;
+
+    // NFTokenMint with TransferFee, Flags (burnable and transferable), NFTokenTaxon,
+    // Fee, URI and Account
+    uint8_t data[] = {0x12, 0x00, 0x19, 0x14, 0x01, 0xf4, 0x22, 0x80, 0x00, 0x00, 0x09,
+                      0x20, 0x2a, 0x00, 0x00, 0x00, 0x07, 0x68, 0x40, 0x00, 0x00, 0x00,
+                      0x00, 0x00, 0x00, 0x0a, 0x75, 0x04, 'i',  'p',  'f',  's',  0x81,
+                      0x14, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42,
+                      0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42};
+
+    assert_int_equal(parse_data(data, sizeof(data)), 0);
+    assert_field_value("Transaction Type", "Mint NFToken");
+    assert_field_value("Transfer Fee", "500");
+    assert_field_value("Flags", "Burnable, Transferable");
+    assert_field_value("Token Taxon", "7");
+    assert_field_value("URI", "ipfs");
+
+    // Unknown transaction types are still displayed
+    data[2] = 0xfe;
+    assert_int_equal(parse_data(data, sizeof(data)), 0);
+    assert_field_value("Transaction Type", "Unknown");
+    assert_field_value("Flags", "No flags for transaction type 254");
+}
+
+void test_transaction_schema(void **state) {
+    (void) state;
+
+    uint8_t data[256];
+    size_t size = build_payment_with_memos(data, 1);
+    assert_int_equal(parse_data(data, size), 0);
+
+    // Payment without Destination, which is followed by the memos
+    uint8_t *destination = data + 26 + 2 + XRP_ACCOUNT_SIZE;
+    assert_int_equal(destination[0], 0x83);
+    memmove(destination, destination + 2 + XRP_ACCOUNT_SIZE, 13);
+    assert_int_equal(parse_data(data, size - 2 - XRP_ACCOUNT_SIZE), REQUIRED_FIELD_MISSING);
+
+    // The fields of memos aren't checked against the schema, but an AccountSet
+    // doesn't allow Amount
+    size = build_payment_with_memos(data, 1);
+    data[2] = 0x03;
+    assert_int_equal(parse_data(data, size), FIELD_NOT_ALLOWED);
+    assert_int_equal(parse_context.offset, 17);
+
+    // Unknown field
+    uint8_t unknown[] = {0x12, 0x00, 0x03, 0x20, 0x32, 0x00, 0x00, 0x00, 0x01};
+    assert_int_equal(parse_data(unknown, sizeof(unknown)), FIELD_NOT_ALLOWED);
+
+    // Fields of transaction types without schema aren't checked
+    unknown[2] = 0x23;
+    assert_int_equal(parse_data(unknown, sizeof(unknown)), 0);
+}
+
+static void assert_parse_error(uint16_t offset, uint8_t data_type, uint8_t id, uint8_t reason) {
+    assert_int_equal(parse_context.error.offset, offset);
+    assert_int_equal(parse_context.error.data_type, data_type);
+    assert_int_equal(parse_context.error.id, id);
+    assert_int_equal(parse_context.error.reason, reason);
+}
+
+void test_parse_diagnostics(void **state) {
+    (void) state;
+
+    // Two Amount fields, the second one breaking the canonical order
+    uint8_t amounts[40];
+    memset(amounts, 0x61, sizeof(amounts));
+    assert_int_equal(parse_data(amounts, sizeof(amounts)), INVALID_STATE);
+    assert_parse_error(9, STI_AMOUNT, 1, PARSE_REASON_FIELD_ORDER);
+
+    // Amount isn't allowed in an AccountSet
+    uint8_t data[256];
+    size_t size = build_payment_with_memos(data, 1);
+    data[2] = 0x03;
+    assert_int_equal(parse_data(data, size), FIELD_NOT_ALLOWED);
+    assert_parse_error(8, STI_AMOUNT, 1, PARSE_REASON_FIELD_NOT_ALLOWED);
+
+    // Payment without Amount and Destination, the first missing one is reported
+    uint8_t payment[] = {0x12, 0x00, 0x00};
+    assert_int_equal(parse_data(payment, sizeof(payment)), REQUIRED_FIELD_MISSING);
+    assert_parse_error(sizeof(payment), STI_AMOUNT, 1, PARSE_REASON_FIELD_MISSING);
+
+    // Truncated Account field
+    uint8_t truncated[] = {0x12, 0x00, 0x03, 0x81, 0x14, 0x01, 0x02};
+    assert_int_equal(parse_data(truncated, sizeof(truncated)), EXCEPTION_OVERFLOW);
+    assert_parse_error(3, STI_ACCOUNT, 1, PARSE_REASON_TRUNCATED);
+
+    // Memos array that is never terminated
+    size = build_payment_with_memos(data, 1);
+    assert_int_equal(parse_data(data, size - 1), INVALID_STATE);
+    assert_parse_error(size - 1, 0, 0, PARSE_REASON_UNTERMINATED);
+
+    // Successful parsing leaves no diagnostics
+    size = build_payment_with_memos(data, 1);
+    assert_int_equal(parse_data(data, size), 0);
+    assert_parse_error(0, 0, 0, PARSE_REASON_NONE);
+}
+
+void test_field_registry(void **state) {
+    (void) state;
+
+    static uint16_t keys[256];
+    int count = 0;
+
+    // Every entry must be found by the binary search, which requires the registry
+    // to be sorted by type and field code
+    for (int type = 0; type < 256; type++) {
+        for (int id = 0; id < 256; id++) {
+            field_t field = {.data_type = type, .id = id};
+            set_field_info(&field);
+            if (field.info == 0) {
+                assert_string_equal(resolve_field_name(&field), "Unknown");
+                continue;
+            }
+
+            const fieldInfo_t *info = get_field_info(&field);
+            assert_int_equal(info->data_type, type);
+            assert_int_equal(info->id, id);
+            keys[field.info] = type << 8 | id;
+            count++;
+        }
+    }
+
+    for (int i = 1; i <= count; i++) {
+        assert_true(keys[i] != 0);
+        assert_true(i == 1 || keys[i - 1] < keys[i]);
+    }
+
+    field_t field = {.data_type = STI_UINT32, .id = XRP_UINT32_LAST_LEDGER_SEQUENCE};
+    set_field_info(&field);
+    assert_string_equal(resolve_field_name(&field), "Last Ledger Sequence");
+    assert_true(is_field_hidden(&parse_context, &field));
+    field.array_info.type = STI_ARRAY;
+    assert_false(is_field_hidden(&parse_context, &field));
+}
+
+void test_format_cache(void **state) {
+    (void) state;
+
+    static formatCache_t cache;
+    size_t size;
+    uint8_t *data = load_transaction_data("../testcases/01-payment/16-memos.raw", &size);
+
+    memset(&parse_context, 0, sizeof(parse_context));
+    parse_context.data = data;
+    parse_context.length = size;
+    assert_int_equal(parse_tx(&parse_context), 0);
+    uint8_t count = get_field_count(&parse_context);
+    assert_true(count > FORMAT_CACHE_SIZE);
+
+    // Same title and value as when formatting the field directly
+    format_cache_reset(&cache);
+    for (uint8_t i = 0; i < count; i++) {
+        const formattedField_t *entry = get_formatted_field(&cache, &parse_context, i, WHOLE_FIELD);
+        field_name_t title;
+        field_value_t value;
+        update_title(get_field(&parse_context, i), &title);
+        update_value(get_field(&parse_context, i), &value);
+        assert_int_equal(entry->index, i);
+        assert_string_equal(entry->name.buf, title.buf);
+        assert_string_equal(entry->value.buf, value.buf);
+    }
+    assert_int_equal(cache.hits, 0);
+    assert_int_equal(cache.misses, count);
+
+    // Going back and forth between two steps only formats them once
+    format_cache_reset(&cache);
+    for (int i = 0; i < 4; i++) {
+        get_formatted_field(&cache, &parse_context, 3, 0);
+        get_formatted_field(&cache, &parse_context, 4, 0);
+    }
+    assert_int_equal(cache.hits, 6);
+    assert_int_equal(cache.misses, 2);
+
+    // The least recently used entry is replaced
+    format_cache_reset(&cache);
+    for (uint8_t i = 0; i <= FORMAT_CACHE_SIZE; i++) {
+        get_formatted_field(&cache, &parse_context, i, 0);
+    }
+    get_formatted_field(&cache, &parse_context, FORMAT_CACHE_SIZE, 0);
+    assert_int_equal(cache.hits, 1);
+    get_formatted_field(&cache, &parse_context, 0, 0);
+    assert_int_equal(cache.misses, FORMAT_CACHE_SIZE + 2);
+
+    // An entry asked for again outlives the entries formatted before it
+    format_cache_reset(&cache);
+    for (uint8_t i = 0; i < FORMAT_CACHE_SIZE; i++) {
+        get_formatted_field(&cache, &parse_context, i, 0);
+    }
+    const formattedField_t *first = get_formatted_field(&cache, &parse_context, 0, 0);
+    get_formatted_field(&cache, &parse_context, FORMAT_CACHE_SIZE, 0);
+    assert_ptr_equal(get_formatted_field(&cache, &parse_context, 0, 0), first);
+    assert_int_equal(cache.hits, 2);
+    get_formatted_field(&cache, &parse_context, 1, 0);
+    assert_int_equal(cache.misses, FORMAT_CACHE_SIZE + 2);
+
+    free(data);
+}
+
+void test_field_pages(void **state) {
+    (void) state;
+
+    static formatCache_t cache;
+    static char whole[2 * MAX_RAW_TX + 1];
+    static char joined[2 * MAX_RAW_TX + 1];
+    size_t size;
+    uint8_t *data = load_transaction_data("../testcases/01-payment/16-memos.raw", &size);
+
+    memset(&parse_context, 0, sizeof(parse_context));
+    parse_context.data = data;
+    parse_context.length = size;
+    assert_int_equal(parse_tx(&parse_context), 0);
+
+    format_cache_reset(&cache);
+    uint16_t item = 0;
+    bool found_pages = false;
+    for (uint8_t i = 0; i < get_field_count(&parse_context); i++) {
+        field_t *field = get_field(&parse_context, i);
+        uint8_t page_count = get_field_page_count(&parse_context, field);
+        found_pages |= page_count > 1;
+
+        // The whole value, without the limit of a field_value_t
+        textWriter_t out;
+        writer_init(&out, whole, sizeof(whole));
+        if (field->data_type == STI_VL) {
+            blob_formatter(&parse_context, field, &out);
+        } else {
+            field_value_t value;
+            format_field(&parse_context, field, &value);
+            write_string(&out, value.buf);
+        }
+        if (out.length == 0) {
+            write_char(&out, ' ');
+        }
+
+        // The pages put together are the whole value
+        writer_init(&out, joined, sizeof(joined));
+        for (uint8_t page = 0; page < page_count; page++, item++) {
+            const formattedField_t *entry = get_formatted_field(&cache, &parse_context, i, page);
+            assert_int_equal(entry->page_count, page_count);
+            assert_true(strlen(entry->value.buf) < MAX_FIELD_LEN);
+            write_string(&out, entry->value.buf);
+
+            field_name_t title;
+            update_title(get_field(&parse_context, i), &title);
+            if (page_count > 1) {
+                size_t len = strlen(title.buf);
+                snprintf(title.buf + len,
+                         sizeof(title.buf) - len,
+                         " (%d/%d)",
+                         page + 1,
+                         page_count);
+            }
+            assert_string_equal(entry->name.buf, title.buf);
+
+            uint8_t index;
+            uint8_t item_page;
+            get_display_item(&parse_context, item, &index, &item_page);
+            assert_int_equal(index, i);
+            assert_int_equal(item_page, page);
+        }
+        assert_false(out.overflow);
+        assert_string_equal(joined, whole);
+    }
+    assert_true(found_pages);
+    assert_int_equal(get_display_item_count(&parse_context), item);
+
+    free(data);
+}
+
+#ifndef PARSE_CHECKPOINT_INTERVAL
+void test_sort_fields(void **state) {
+    (void) state;
+
+    static parseResult_t result;
+    uint32_t seed = 1;
+
+    for (int n = 0; n <= MAX_FIELD_COUNT; n++) {
+        memset(&result, 0, sizeof(result));
+        result.num_fields = n;
+
+        // The offset records the parsing order of each field
+        for (int i = 0; i < n; i++) {
+            field_t *field = &result.fields[i];
+            seed = seed * 1103515245 + 12345;
+            switch ((seed >> 16) % 4) {
+                case 0:
+                    field->data_type = STI_UINT16;
+                    field->id = XRP_UINT16_TRANSACTION_TYPE;
+                    break;
+                case 1:
+                    field->data_type = STI_ACCOUNT;
+                    field->id = XRP_ACCOUNT_ACCOUNT;
+                    break;
+                default:
+                    field->data_type = STI_UINT32;
+                    field->id = XRP_UINT32_FLAGS;
+                    break;
+            }
+            set_field_info(field);
+            field->offset = i;
+        }
+
+        sort_fields(&result);
+
+        for (int i = 1; i < n; i++) {
+            field_t *previous = &result.fields[i - 1];
+            field_t *field = &result.fields[i];
+            assert_true(get_priority_score(previous) <= get_priority_score(field));
+            if (get_priority_score(previous) == get_priority_score(field)) {
+                assert_true(previous->offset < field->offset);
+            }
+        }
+    }
+}
+
+static parseContext_t general_context;
+
+// Parse the data one byte at a time, so that the first field is read before the
+// whole simple payment has been received and the fast path is never taken
+static int parse_general(uint8_t *data, size_t size) {
+    memset(&general_context, 0, sizeof(general_context));
+    general_context.data = data;
+    parse_tx_init(&general_context);
+
+    while (general_context.length < size) {
+        general_context.length++;
+        int err = parse_tx_update(&general_context);
+        if (err != 0) {
+            return err;
+        }
+    }
+
+    return parse_tx_finish(&general_context);
+}
+
+// Parse the data with and without the fast path, returns whether it was taken
+static bool check_simple_payment(uint8_t *data, size_t size) {
+    memset(&parse_context, 0, sizeof(parse_context));
+    parse_context.data = data;
+    parse_context.length = size;
+    parse_tx_init(&parse_context);
+    bool is_simple = parse_simple_payment(&parse_context);
+    uint32_t simple_end = parse_context.offset;
+
+    int err = parse_tx_update(&parse_context);
+    if (err == 0) {
+        err = parse_tx_finish(&parse_context);
+    }
+
+    assert_int_equal(err, parse_general(data, size));
+    if (err != 0) {
+        // The fields decoded by the fast path must be valid, only what follows can be
+        // rejected by the general parser
+        if (is_simple) {
+            assert_true(general_context.error.offset >= simple_end);
+        }
+        assert_memory_equal(&parse_context.error, &general_context.error, sizeof(parseError_t));
+        return is_simple;
+    }
+
+    assert_int_equal(parse_context.offset, general_context.offset);
+    assert_int_equal(parse_context.transaction_type, general_context.transaction_type);
+    assert_ptr_equal(parse_context.transaction_info, general_context.transaction_info);
+    assert_int_equal(parse_context.has_empty_pub_key, general_context.has_empty_pub_key);
+    assert_int_equal(parse_context.schema_fields, general_context.schema_fields);
+    assert_memory_equal(parse_context.seen_fields,
+                        general_context.seen_fields,
+                        sizeof(parse_context.seen_fields));
+    assert_memory_equal(&parse_context.frames[0], &general_context.frames[0], sizeof(parseFrame_t));
+    assert_int_equal(parse_context.result.num_fields, general_context.result.num_fields);
+    assert_memory_equal(parse_context.result.fields,
+                        general_context.result.fields,
+                        parse_context.result.num_fields * sizeof(field_t));
+
+    return is_simple;
+}
+
+// Every truncation and single byte change must give the same result as the general parser
+static void check_simple_payment_changes(uint8_t *data, size_t size) {
+    for (size_t length = 0; length < size; length++) {
+        check_simple_payment(data, length);
+    }
+
+    static const uint8_t changes[] = {0x01, 0x10, 0x80, 0xff};
+    for (size_t i = 0; i < size; i++) {
+        for (size_t j = 0; j < sizeof(changes); j++) {
+            data[i] ^= changes[j];
+            check_simple_payment(data, size);
+            data[i] ^= changes[j];
+        }
+    }
+}
+
+// Payment with all the fields of the fast path, LastLedgerSequence being the only one
+// with a two byte header
+static size_t build_simple_payment(uint8_t *data) {
+    const uint8_t fields[] = {
+        0x12, 0x00, 0x00,                                      // TransactionType
+        0x22, 0x80, 0x00, 0x00, 0x00,                          // Flags
+        0x24, 0x00, 0x00, 0x00, 0x01,                          // Sequence
+        0x2e, 0x00, 0x00, 0x30, 0x39,                          // DestinationTag
+        0x20, 0x1b, 0x00, 0x00, 0x10, 0x00,                    // LastLedgerSequence
+        0x61, 0x40, 0x00, 0x00, 0x00, 0x00, 0x0f, 0x42, 0x40,  // Amount
+        0x68, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0c,  // Fee
+        0x73, 0x00,                                            // SigningPubKey
+    };
+    size_t size = sizeof(fields);
+    memcpy(data, fields, size);
+
+    // Account and Destination
+    data[size++] = 0x81;
+    data[size++] = 0x14;
+    memset(data + size, 0x42, XRP_ACCOUNT_SIZE);
+    size += XRP_ACCOUNT_SIZE;
+    data[size++] = 0x83;
+    data[size++] = 0x14;
+    memset(data + size, 0x43, XRP_ACCOUNT_SIZE);
+    size += XRP_ACCOUNT_SIZE;
+
+    return size;
+}
+
+void test_simple_payment_headers(void **state) {
+    (void) state;
+
+    uint8_t data[128];
+    size_t size = build_simple_payment(data);
+    const size_t last_ledger = 18;
+
+    // LastLedgerSequence has a two byte header
+    assert_true(check_simple_payment(data, size));
+    assert_true(has_field(&parse_context, STI_UINT32, XRP_UINT32_LAST_LEDGER_SEQUENCE));
+    check_simple_payment_changes(data, size);
+
+    // Truncated anywhere, the fast path leaves it to the general parser
+    for (size_t length = 0; length < size; length++) {
+        assert_false(check_simple_payment(data, length));
+    }
+
+    // A one byte header with the field code of LastLedgerSequence and the wrong type,
+    // 0x3b being a UInt64 that would be followed by 8 bytes
+    uint8_t wrong_type[128];
+    memcpy(wrong_type, data, last_ledger);
+    wrong_type[last_ledger] = 0x3b;
+    memcpy(wrong_type + last_ledger + 1, data + last_ledger + 2, size - last_ledger - 2);
+    assert_false(check_simple_payment(wrong_type, size - 1));
+    check_simple_payment_changes(wrong_type, size - 1);
+
+    // Sequence before Flags
+    uint8_t unsorted[128];
+    memcpy(unsorted, data, size);
+    memcpy(unsorted + 3, data + 8, 5);
+    memcpy(unsorted + 8, data + 3, 5);
+    assert_false(check_simple_payment(unsorted, size));
+    assert_int_equal(parse_general(unsorted, size), INVALID_STATE);
+
+    // LastLedgerSequence before DestinationTag
+    memcpy(unsorted, data, size);
+    memcpy(unsorted + 13, data + last_ledger, 6);
+    memcpy(unsorted + 19, data + 13, 5);
+    assert_false(check_simple_payment(unsorted, size));
+    assert_int_equal(parse_general(unsorted, size), INVALID_STATE);
+}
+
+void test_simple_payment(void **state) {
+    (void) state;
+
+    int simple_count = 0;
+
+    for (const char **testcase = testcases; *testcase != NULL; testcase++) {
+        size_t size;
+        uint8_t *data = load_transaction_data(*testcase, &size);
+
+        if (!check_simple_payment(data, size)) {
+            free(data);
+            continue;
+        }
+        simple_count++;
+
+        check_simple_payment_changes(data, size);
+        free(data);
+    }
+
+    // Basic payments, with a destination tag, with memos or other arrays, and multi-signed
+    // ones, with and without LastLedgerSequence
+    assert_int_equal(simple_count, 8);
+}
+#endif
+
+#ifdef PARSE_CHECKPOINT_INTERVAL
+void test_lazy_fields(void **state) {
+    (void) state;
+
+    // Payment with the maximum number of path steps, which results in more
+    // fields than could ever be stored at once
+    uint8_t data[4096];
+    size_t size = build_payment_with_memos(data, 0);
+    size = append_path_set(data, size, MAX_PATH_COUNT * MAX_STEP_COUNT * 2);
+
+    assert_int_equal(parse_data(data, size), 0);
+    assert_int_equal(get_field_count(&parse_context),
+                     PAYMENT_FIELD_COUNT + MAX_PATH_COUNT * MAX_STEP_COUNT * 2);
+
+    // Fields can be accessed in any order
+    for (int i = get_field_count(&parse_context) - 1; i >= PAYMENT_FIELD_COUNT; --i) {
+        field_t *field = get_field(&parse_context, i);
+        int path = (i - PAYMENT_FIELD_COUNT) / (MAX_STEP_COUNT * 2) + 1;
+        int step = (i - PAYMENT_FIELD_COUNT) % (MAX_STEP_COUNT * 2) / 2 + 1;
+        int kind = (i - PAYMENT_FIELD_COUNT) % 2;
+        assert_int_equal(field->data_type, kind == 0 ? STI_CURRENCY : STI_ACCOUNT);
+        assert_int_equal(field->array_info.index1, path);
+        assert_int_equal(field->array_info.index2, step);
+        assert_int_equal(field_data(&parse_context, field)[0], path * 16 + step);
+    }
+
+    // The priority fields are still displayed first
+    assert_int_equal(get_field(&parse_context, 0)->id, XRP_UINT16_TRANSACTION_TYPE);
+    assert_int_equal(get_field(&parse_context, 1)->id, XRP_ACCOUNT_ACCOUNT);
+    assert_int_equal(get_field(&parse_context, 2)->id, XRP_UINT64_AMOUNT);
+    assert_int_equal(get_field(&parse_context, 3)->id, XRP_UINT64_FEE);
+}
+
+void test_lazy_memos(void **state) {
+    (void) state;
+
+    uint8_t data[2048];
+    int memo_count = MAX_ARRAY_LEN;
+
+    memset(&parse_context, 0, sizeof(parse_context));
+    parse_context.data = data;
+    parse_context.length = build_payment_with_memos(data, memo_count);
+    assert_int_equal(parse_tx(&parse_context), 0);
+    uint8_t count = get_field_count(&parse_context);
+    assert_int_equal(count, PAYMENT_FIELD_COUNT + memo_count * 3);
+
+    // Each memo field is a serialized field, so a checkpoint is stored every
+    // PARSE_CHECKPOINT_INTERVAL fields and decoding never restarts further back
+    assert_int_equal(parse_context.num_checkpoints,
+                     (count + PARSE_CHECKPOINT_INTERVAL - 1) / PARSE_CHECKPOINT_INTERVAL);
+    for (uint8_t i = 0; i < parse_context.num_checkpoints; ++i) {
+        parseCheckpoint_t *checkpoint = &parse_context.checkpoints[i];
+        assert_int_equal(checkpoint->ordinal, i * PARSE_CHECKPOINT_INTERVAL);
+        if (checkpoint->ordinal >= PAYMENT_FIELD_COUNT) {
+            // Inside a Memo object, itself inside the Memos array
+            assert_int_equal(checkpoint->depth, 2);
+            assert_int_equal(checkpoint->array_depth, 1);
+        }
+    }
+
+    const uint8_t ids[] = {XRP_VL_MEMO_TYPE, XRP_VL_MEMO_DATA, XRP_VL_MEMO_FORMAT};
+    for (int i = count - 1; i >= PAYMENT_FIELD_COUNT; --i) {
+        field_t *field = get_field(&parse_context, i);
+        assert_int_equal(field->id, ids[(i - PAYMENT_FIELD_COUNT) % 3]);
+        assert_int_equal(field->array_info.type, 9);
+        assert_int_equal(field->array_info.index1, (i - PAYMENT_FIELD_COUNT) / 3 + 1);
+        assert_int_equal(field_data(&parse_context, field)[0], 'a' + (i - PAYMENT_FIELD_COUNT) % 3);
+    }
+
+    // Two arrays are open inside the SignerEntries of memos, so no checkpoint is stored
+    const uint8_t header[] = {0x12, 0x00, 0x03, 0xf9};
+    memcpy(data, header, sizeof(header));
+    size_t size = sizeof(header);
+    for (int i = 0; i < 4 * MAX_ARRAY_LEN; i++) {
+        if (i % MAX_ARRAY_LEN == 0) {
+            data[size++] = 0xea;
+            data[size++] = 0xf4;
+        }
+        data[size++] = 0xeb;
+        data[size++] = 0x81;
+        data[size++] = 0x14;
+        memset(data + size, i + 1, XRP_ACCOUNT_SIZE);
+        size += XRP_ACCOUNT_SIZE;
+        data[size++] = 0xe1;
+        if (i % MAX_ARRAY_LEN == MAX_ARRAY_LEN - 1) {
+            data[size++] = 0xf1;
+            data[size++] = 0xe1;
+        }
+    }
+    data[size++] = 0xf1;
+
+    assert_int_equal(parse_data(data, size), 0);
+    assert_int_equal(parse_context.num_checkpoints, 1);
+    field_t *field = get_field(&parse_context, 4 * MAX_ARRAY_LEN);
+    assert_int_equal(field->array_info.type, 4);
+    assert_int_equal(field->array_info.index1, MAX_ARRAY_LEN);
+    assert_int_equal(field_data(&parse_context, field)[0], 4 * MAX_ARRAY_LEN);
+}
+#endif
+
 int main() {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test(test_transactions),
+        cmocka_unit_test(test_transactions_chunked),
+        cmocka_unit_test(test_chunked_early_rejection),
+        cmocka_unit_test(test_chunked_truncated),
+        cmocka_unit_test(test_canonical_order),
+        cmocka_unit_test(test_many_fields),
+        cmocka_unit_test(test_nested_arrays),
+        cmocka_unit_test(test_nesting_depth),
+        cmocka_unit_test(test_field_registry),
+        cmocka_unit_test(test_modern_transaction_types),
+        cmocka_unit_test(test_transaction_schema),
+        cmocka_unit_test(test_parse_diagnostics),
+        cmocka_unit_test(test_format_cache),
+        cmocka_unit_test(test_field_pages),
+#ifndef PARSE_CHECKPOINT_INTERVAL
+        cmocka_unit_test(test_hidden_fields_at_capacity),
+        cmocka_unit_test(test_sort_fields),
+        cmocka_unit_test(test_simple_payment),
+        cmocka_unit_test(test_simple_payment_headers),
+#else
+        cmocka_unit_test(test_lazy_fields),
+        cmocka_unit_test(test_lazy_memos),
+#endif
     };
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <limits.h>
+#include <stdio.h>
+
+// Ripple epoch time formatting the app used before the 32-bit conversion, a port of musl
+// working on long long, kept as the reference the new code is checked against.
+
+#define REFERENCE_LEAPOCH (946684800LL + 86400 * (31 + 29))
+#define REFERENCE_OFFSET  (946684800LL - REFERENCE_LEAPOCH)
+
+#define REFERENCE_DAYS_PER_400Y (365 * 400 + 97)
+#define REFERENCE_DAYS_PER_100Y (365 * 100 + 24)
+#define REFERENCE_DAYS_PER_4Y   (365 * 4 + 1)
+
+typedef struct {
+    int tm_sec;
+    int tm_min;
+    int tm_hour;
+    int tm_mday;
+    int tm_mon;
+    int tm_year;
+} reference_tm_t;
+
+static inline int reference_epoch_to_tm(long long t, reference_tm_t *tm) {
+    long long days, secs;
+    int remdays, remsecs, remyears;
+    int qc_cycles, c_cycles, q_cycles;
+    int years, months;
+    static const char days_in_month[] = {31, 30, 31, 30, 31, 31, 30, 31, 30, 31, 31, 29};
+
+    if (t < INT_MIN * 31622400LL || t > INT_MAX * 31622400LL) return -1;
+
+    secs = t + REFERENCE_OFFSET;
+    days = secs / 86400;
+    remsecs = secs % 86400;
+    if (remsecs < 0) {
+        remsecs += 86400;
+        days--;
+    }
+
+    qc_cycles = days / REFERENCE_DAYS_PER_400Y;
+    remdays = days % REFERENCE_DAYS_PER_400Y;
+    if (remdays < 0) {
+        remdays += REFERENCE_DAYS_PER_400Y;
+        qc_cycles--;
+    }
+
+    c_cycles = remdays / REFERENCE_DAYS_PER_100Y;
+    if (c_cycles == 4) c_cycles--;
+    remdays -= c_cycles * REFERENCE_DAYS_PER_100Y;
+
+    q_cycles = remdays / REFERENCE_DAYS_PER_4Y;
+    if (q_cycles == 25) q_cycles--;
+    remdays -= q_cycles * REFERENCE_DAYS_PER_4Y;
+
+    remyears = remdays / 365;
+    if (remyears == 4) remyears--;
+    remdays -= remyears * 365;
+
+    years = remyears + 4 * q_cycles + 100 * c_cycles + 400 * qc_cycles;
+
+    for (months = 0; days_in_month[months] <= remdays; months++) remdays -= days_in_month[months];
+
+    if (years + 100 > INT_MAX || years + 100 < INT_MIN) return -1;
+
+    tm->tm_year = years + 100;
+    tm->tm_mon = months + 2;
+    if (tm->tm_mon >= 12) {
+        tm->tm_mon -= 12;
+        tm->tm_year++;
+    }
+    tm->tm_mday = remdays + 1;
+
+    tm->tm_hour = remsecs / 3600;
+    tm->tm_min = remsecs / 60 % 60;
+    tm->tm_sec = remsecs % 60;
+
+    return 0;
+}
+
+static inline void reference_format_time(uint32_t value, char *buf, size_t size) {
+    reference_tm_t tm;
+    reference_epoch_to_tm(value, &tm);
+
+    snprintf(buf,
+             size,
+             "%u-%02u-%02u %02u:%02u:%02u UTC",
+             tm.tm_year + 1900,
+             tm.tm_mon + 1,
+             tm.tm_mday,
+             tm.tm_hour,
+             tm.tm_min,
+             tm.tm_sec);
+}
@@ -1,7 +1,7 @@
 from pathlib import Path
 import json
 import re
-from typing import Tuple
+from typing import List, Tuple
 from struct import unpack
 
 from hashlib import sha256, sha512
@@ -54,6 +54,33 @@ def unpack_get_public_key_response(reply: bytes) -> Tuple[int, str, int, str]:
     return key_len, key_data.hex(), len(chain_data), chain_data.hex()
 
 
+def unpack_parse_error(reply: bytes) -> Tuple[int, int, int, int]:
+    """ Unpack the data of a rejected 'sign' APDU:
+           offset (2)
+           data_type (1)
+           field_id (1)
+           reason (1)
+    """
+
+    assert len(reply) == 5
+    offset, data_type, field_id, reason = unpack(">HBBB", reply)
+    return offset, data_type, field_id, reason
+
+
+def unpack_parse_summary(reply: bytes) -> Tuple[int, int, int, List[Tuple[int, int, int, int]]]:
+    """ Unpack reply for 'parse' APDU:
+           transaction_type (2)
+           field_count (1)
+           screen_count (1)
+           data_type (1), field_id (1), offset (2), length (2) of each field
+    """
+
+    assert len(reply) >= 4 and (len(reply) - 4) % 6 == 0
+    transaction_type, field_count, screen_count = unpack(">HBB", reply[:4])
+    fields = [unpack(">BBHH", reply[i:i + 6]) for i in range(4, len(reply), 6)]
+    return transaction_type, field_count, screen_count, fields
+
+
 def verify_version(root_path: Path, version: str) -> None:
     """ Verify the app version, based on defines in Makefile """
 
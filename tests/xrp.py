@@ -1,5 +1,5 @@
 from contextlib import contextmanager
-from typing import Optional, Tuple
+from typing import List, Optional, Tuple
 from enum import IntEnum
 from ragger.backend.interface import BackendInterface, RAPDU
 from ragger.firmware import Firmware
@@ -7,6 +7,7 @@ from ragger.navigator import Navigator
 from ragger.utils.misc import split_message
 
 from .utils import DEFAULT_BIP32_PATH, unpack_get_public_key_response, unpack_configuration_response
+from .utils import unpack_parse_error, unpack_parse_summary
 
 
 MAX_APDU_LEN: int = 255
@@ -15,6 +16,7 @@ class Ins(IntEnum):
     GET_PUBLIC_KEY = 0x02
     SIGN = 0x04
     GET_CONFIGURATION = 0x06
+    PARSE = 0x08
 
 
 class P1(IntEnum):
@@ -33,6 +35,27 @@ class P2(IntEnum):
     CURVE_ED25519 = 0x80
 
 
+class ParseReason(IntEnum):
+    NONE = 0
+    TRUNCATED = 1
+    LENGTH_TOO_LARGE = 2
+    TOO_MANY_FIELDS = 3
+    UNSUPPORTED_TYPE = 4
+    TOO_DEEP = 5
+    TOO_MANY_ITEMS = 6
+    TOO_MANY_PATHS = 7
+    TOO_MANY_STEPS = 8
+    UNEXPECTED_END = 9
+    NOT_AN_OBJECT = 10
+    FIELD_ORDER = 11
+    NOT_FULLY_CANONICAL = 12
+    ACCOUNT_LENGTH = 13
+    FIELD_NOT_ALLOWED = 14
+    FIELD_MISSING = 15
+    UNTERMINATED = 16
+    DUPLICATE_PRIORITY = 17
+
+
 class Action(IntEnum):
     NAVIGATE = 0
     COMPARE = 1
@@ -46,6 +69,9 @@ class Errors(IntEnum):
     SW_INTERNAL_1               = 0x6803
     SW_INTERNAL_2               = 0x6807
     SW_INTERNAL_3               = 0x6813
+    SW_INTERNAL_4               = 0x6809
+    SW_FIELD_NOT_ALLOWED        = 0x6820
+    SW_REQUIRED_FIELD_MISSING   = 0x6821
     SW_SECURITY_STATUS          = 0x6982
     SW_WRONG_ADDRESS            = 0x6985
     SW_INVALID_PATH             = 0x6A80
@@ -122,6 +148,31 @@ class XRPClient:
         with self._exchange_async(Ins.SIGN, p1, P2.CURVE_SECP256K1, messages[-1]) as reply:
             yield reply
 
+    def parse(self, payload) -> Tuple[int, int, int, List[Tuple[int, int, int, int]]]:
+        """ Validate a transaction without reviewing it, the payload being the same as for 'sign' """
+        messages = split_message(payload, MAX_APDU_LEN)
+        if len(messages) == 1:
+            p1 = P1.ONLY
+        else:
+            p1 = P1.FIRST
+            for msg in messages[:-1]:
+                self._exchange(Ins.PARSE, p1, P2.CURVE_SECP256K1, msg)
+                p1 = P1.INTER
+            p1 = P1.LAST
+        reply = self._exchange(Ins.PARSE, p1, P2.CURVE_SECP256K1, messages[-1])
+        assert reply.status == Errors.SW_SUCCESS
+        return unpack_parse_summary(reply.data)
+
+    def send_chunk(self, ins: int, p1: int, data: bytes) -> RAPDU:
+        """ Send a single chunk of a transaction upload, with 'sign' or 'parse' """
+        return self._exchange(ins, p1, P2.CURVE_SECP256K1, data)
+
+    @staticmethod
+    def get_parse_error(data: bytes) -> Tuple[int, int, int, ParseReason]:
+        """ Where and why a transaction sent with 'sign' was rejected """
+        offset, data_type, field_id, reason = unpack_parse_error(data)
+        return offset, data_type, field_id, ParseReason(reason)
+
     def get_async_response(self) -> Optional[RAPDU]:
         """ Asynchronous APDU reply """
         return self._client.last_async_response